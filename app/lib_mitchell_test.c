@@ -34,6 +34,9 @@ int button_UNIT_TEST(void);
 int sh_UNIT_TEST(void);
 int bitvector_UNIT_TEST(void);
 int pool_UNIT_TEST(void);
+int fir_UNIT_TEST(void);
+int decimator_UNIT_TEST(void);
+int cic_UNIT_TEST(void);
 
 ASSERT_INIT;
 
@@ -53,6 +56,9 @@ int main(void) {
     test_result_failures += sh_UNIT_TEST();
     test_result_failures += bitvector_UNIT_TEST();
     test_result_failures += pool_UNIT_TEST();
+    test_result_failures += fir_UNIT_TEST();
+    test_result_failures += decimator_UNIT_TEST();
+    test_result_failures += cic_UNIT_TEST();
 
     for (;;) { } // wait for debugger inspection
 
@@ -22,6 +22,7 @@
 
     #define CPU_LOCK     uint32_t primask_save = __get_PRIMASK(); __disable_irq()
     #define CPU_END_LOCK __set_PRIMASK(primask_save)
+    #define CPU_DMB      __DMB()    // order memory accesses, e.g. publish data before the index that makes it visible
 
     #if (__CORTEX_M == 0)
         #include "core_cm0plus.h"
@@ -34,7 +35,7 @@
 
 /*
  * Unit test are by definition single threaded and may be run on
- * a host (i.e. non ARM) computer, so no locking.
+ * a host (i.e. non ARM) computer, so no locking and only a compiler barrier.
  *
  * The CAS operation has hooks installed before, during, and after
  * to allow simulation of context changes occurring at any time.
@@ -42,6 +43,7 @@
 #if defined (UNIT_TEST)
     #define CPU_LOCK
     #define CPU_END_LOCK
+    #define CPU_DMB      __asm volatile ("" ::: "memory")
 
 void test_preCAS(void);
 int  test_CAS_OP(uint32_t volatile * const addr, uint32_t const expected, uint32_t const store);
@@ -0,0 +1,530 @@
+/*****************************************************************************
+
+      (c) Copyright 2016 DDPA LLC
+      ALL RIGHTS RESERVED.
+
+    dsp.c - Fixed point filters built on the DL delay line of memory.c.
+
+    FIR:  A Q15 or Q31 finite impulse response filter with block processing.
+
+    DECIMATOR, INTERPOLATOR: Polyphase FIR sample rate conversion.
+
+    CIC:  A multiplierless cascaded integrator-comb decimator.
+
+ *****************************************************************************/
+
+#include  <string.h>
+#include  "cpu.h"
+#include  "dbc.h"
+#include  "memory.h"
+#include  "dsp.h"
+
+
+/*****************************************************************************
+
+   Saturate a 64 bit accumulator of products to the output format.
+
+ *****************************************************************************/
+
+static inline q15_t dspSatQ15(int64_t acc) {
+    acc >>= 15;
+    return ((q15_t) ((acc > INT16_MAX) ? INT16_MAX : (acc < INT16_MIN) ? INT16_MIN : acc));
+}
+
+static inline q31_t dspSatQ31(int64_t acc) {
+    acc >>= 31;
+    return ((q31_t) ((acc > INT32_MAX) ? INT32_MAX : (acc < INT32_MIN) ? INT32_MIN : acc));
+}
+
+
+
+/*****************************************************************************
+
+   FIR: A fixed point finite impulse response filter with block processing.
+
+        The newest sample is inserted into the mirrored delay line and the
+        output is the dot product of dlWindow(), tap zero first, with the
+        coefficients. There is no wrap check in the inner loop.
+
+        The Cortex-M4 Q15 kernel loads two taps of the window and two
+        coefficients as one word each and accumulates both products with
+        __SMLALD, four taps per iteration. The window starts at any half
+        word, the CM4 supports unaligned word loads. An odd number of taps
+        finishes in C.
+
+   Revision History:
+    10/16/26  Initial release
+
+ *****************************************************************************/
+
+static q15_t firDotQ15(const q15_t * x, const q15_t * h, mem_index_t taps) {
+    int64_t acc = 0;
+
+#if (DSP_SIMD)
+    uint32_t x01, x23, h01, h23;
+
+    for (; taps >= 4; taps -= 4, x += 4, h += 4) {
+        memcpy(&x01, &x[0], sizeof(x01));
+        memcpy(&h01, &h[0], sizeof(h01));
+        memcpy(&x23, &x[2], sizeof(x23));
+        memcpy(&h23, &h[2], sizeof(h23));
+        acc = (int64_t) __SMLALD(x01, h01, (uint64_t) acc);
+        acc = (int64_t) __SMLALD(x23, h23, (uint64_t) acc);
+    }
+    if (taps >= 2) {
+        memcpy(&x01, &x[0], sizeof(x01));
+        memcpy(&h01, &h[0], sizeof(h01));
+        acc = (int64_t) __SMLALD(x01, h01, (uint64_t) acc);
+        taps -= 2; x += 2; h += 2;
+    }
+#endif
+
+    while (taps--) { acc += (int32_t) *x++ * *h++; }
+
+    return (dspSatQ15(acc));
+}
+
+static q31_t firDotQ31(const q31_t * x, const q31_t * h, mem_index_t taps) {
+    int64_t acc = 0;
+
+    for (; taps >= 4; taps -= 4, x += 4, h += 4) {
+        acc += (int64_t) x[0] * h[0];
+        acc += (int64_t) x[1] * h[1];
+        acc += (int64_t) x[2] * h[2];
+        acc += (int64_t) x[3] * h[3];
+    }
+    while (taps--) { acc += (int64_t) *x++ * *h++; }
+
+    return (dspSatQ31(acc));
+}
+
+
+/*
+ * Filter n samples of in to out. in and out may be the same buffer.
+ */
+void firProcess(fir_t * fir, const void * in, void * out, uint32_t n) {
+
+    REQUIRE (fir->taps > 0);
+    REQUIRE (dlTaps(fir->dl) == fir->taps);
+
+    if (fir->format == FIR_Q15) {
+        const q15_t * x = (const q15_t *) in;
+        q15_t *       y = (q15_t *) out;
+        for (uint32_t i=0; i<n; ++i) {
+            dlUpdate(fir->dl, (void *) &x[i]);
+            y[i] = firDotQ15(dlWindow(fir->dl), fir->coeffs, fir->taps);
+        }
+    }
+    else {
+        REQUIRE (fir->format == FIR_Q31);
+        const q31_t * x = (const q31_t *) in;
+        q31_t *       y = (q31_t *) out;
+        for (uint32_t i=0; i<n; ++i) {
+            dlUpdate(fir->dl, (void *) &x[i]);
+            y[i] = firDotQ31(dlWindow(fir->dl), fir->coeffs, fir->taps);
+        }
+    }
+}
+
+
+
+/*****************************************************************************
+
+   DECIMATOR, INTERPOLATOR: Polyphase FIR sample rate conversion.
+
+        The decimator delay line holds the last taps inputs. The inputs up to
+        the next output are inserted with one dlUpdateN and the output is
+        the FIR convolution of the window. Inputs that arrive between outputs
+        are not filtered at all.
+
+        The interpolator delay line holds the last taps / L inputs. Output
+        phase p of L is the dot product of the window with coeffs[p],
+        coeffs[p + L], ... which are the coefficients that meet a non-zero
+        sample of the zero stuffed input.
+
+   Revision History:
+    10/16/26  Initial release
+
+ *****************************************************************************/
+
+/*
+ * Filter n samples of in. out must hold (n + M - 1) / M outputs. Returns the
+ * number of outputs, which depends on the inputs left over from the last call.
+ */
+uint32_t decimProcess(decimator_t * dec, const void * in, void * out, uint32_t n) {
+    const char *  x = (const char *) in;
+    size_t        size = (dec->format == FIR_Q15) ? sizeof(q15_t) : sizeof(q31_t);
+    uint32_t      outputs = 0;
+    mem_index_t   k;
+
+    REQUIRE (dec->taps > 0);
+    REQUIRE (dlTaps(dec->dl) == dec->taps);
+    REQUIRE ((dec->phase > 0) && (dec->phase <= dec->factor));
+
+    while (n) {
+        k = (mem_index_t) MIN(n, dec->phase);
+        dlUpdateN(dec->dl, x, k);
+        x          += k * size;
+        n          -= k;
+        dec->phase -= k;
+
+        if (!dec->phase) {
+            dec->phase = dec->factor;
+            if (dec->format == FIR_Q15) {
+                ((q15_t *) out)[outputs++] = firDotQ15(dlWindow(dec->dl), dec->coeffs, dec->taps);
+            }
+            else {
+                ((q31_t *) out)[outputs++] = firDotQ31(dlWindow(dec->dl), dec->coeffs, dec->taps);
+            }
+        }
+    }
+    return (outputs);
+}
+
+
+/*
+ * Filter n samples of in to n * L samples of out. in and out may not overlap.
+ */
+void interpProcess(interpolator_t * interp, const void * in, void * out, uint32_t n) {
+    mem_index_t   phases = dlTaps(interp->dl);
+    mem_index_t   L = interp->factor;
+    int64_t       acc;
+
+    REQUIRE (interp->taps > 0);
+    REQUIRE (phases == (interp->taps + L - 1) / L);
+
+    for (uint32_t i=0; i<n; ++i) {
+        if (interp->format == FIR_Q15) {
+            const q15_t * h = (const q15_t *) interp->coeffs;
+            const q15_t * x;
+            dlUpdate(interp->dl, (void *) &((const q15_t *) in)[i]);
+            x = dlWindow(interp->dl);
+            for (mem_index_t p=0; p<L; ++p) {
+                acc = 0;
+                for (mem_index_t j=0, k=p; k<interp->taps; ++j, k+=L) { acc += (int32_t) x[j] * h[k]; }
+                ((q15_t *) out)[(i * L) + p] = dspSatQ15(acc);
+            }
+        }
+        else {
+            const q31_t * h = (const q31_t *) interp->coeffs;
+            const q31_t * x;
+            dlUpdate(interp->dl, (void *) &((const q31_t *) in)[i]);
+            x = dlWindow(interp->dl);
+            for (mem_index_t p=0; p<L; ++p) {
+                acc = 0;
+                for (mem_index_t j=0, k=p; k<interp->taps; ++j, k+=L) { acc += (int64_t) x[j] * h[k]; }
+                ((q31_t *) out)[(i * L) + p] = dspSatQ31(acc);
+            }
+        }
+    }
+}
+
+
+
+/*****************************************************************************
+
+   CIC: A cascaded integrator-comb decimator by R of order N.
+
+        The integrators are held in locals for the block and every input
+        costs N adds. The combs run once per output. All arithmetic is
+        uint32_t, whose wrap around is defined, and the final difference is
+        the exact output modulo 2^32.
+
+        The output shift is recomputed each call from N and R, the cost is
+        N multiplies per block.
+
+   Revision History:
+    10/16/26  Initial release
+
+ *****************************************************************************/
+
+/*
+ * Filter n samples of in. out must hold (n + R - 1) / R outputs. Returns the
+ * number of outputs, which depends on the inputs left over from the last call.
+ */
+uint32_t cicProcess(cic_t * cic, const q15_t * in, q15_t * out, uint32_t n) {
+    uint32_t    integrator[CIC_ORDER_MAX];
+    uint32_t *  comb = &cic->state[cic->order];
+    uint64_t    gain = 1;
+    int         bits = cic->input_bits;
+    uint32_t    acc, delayed, outputs = 0;
+
+    REQUIRE ((cic->order > 0) && (cic->order <= CIC_ORDER_MAX));
+    REQUIRE ((cic->phase > 0) && (cic->phase <= cic->rate));
+
+    for (int s=0; s<cic->order; ++s) { gain *= cic->rate; }
+    while (((uint64_t) 1 << (bits - cic->input_bits)) < gain) { ++bits; }   // output width
+    REQUIRE (bits <= 32);
+
+    memcpy(integrator, cic->state, cic->order * sizeof(uint32_t));
+
+    for (uint32_t i=0; i<n; ++i) {
+        acc = (uint32_t) (int32_t) in[i];
+        for (int s=0; s<cic->order; ++s) {
+            integrator[s] += acc;
+            acc = integrator[s];
+        }
+        if (!--cic->phase) {
+            cic->phase = cic->rate;
+            for (int s=0; s<cic->order; ++s) {
+                delayed = comb[s];
+                comb[s] = acc;
+                acc    -= delayed;
+            }
+            out[outputs++] = (q15_t) ((bits > 16) ? ((int32_t) acc >> (bits - 16)) : ((int32_t) acc << (16 - bits)));
+        }
+    }
+
+    memcpy(cic->state, integrator, cic->order * sizeof(uint32_t));
+
+    if (cic->compensator) {
+        REQUIRE (cic->compensator->format == FIR_Q15);
+        firProcess(cic->compensator, out, out, outputs);
+    }
+    return (outputs);
+}
+
+
+
+
+#ifdef UNIT_TEST
+
+#include  <stdbool.h>
+
+#define FIR_TEST_SAMPLES    64
+
+static const q15_t fir_coeffs_q15[9] = { 1200, -2500, 4100, 16000, 30000, 16000, 4100, -2500, 1200 };
+static const q31_t fir_coeffs_q31[5] = { 0x08000000, -0x10000000, 0x40000000, -0x10000000, 0x08000000 };
+static const q15_t fir_max_q15[4]    = { INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX };
+
+NEW_FIR_Q15(fir_q15_9, fir_coeffs_q15, 9);       // odd number of taps
+NEW_FIR_Q15(fir_q15_8, fir_coeffs_q15, 8);       // even number of taps
+NEW_FIR_Q15(fir_q15_1, fir_coeffs_q15, 1);       // smallest possible filter
+NEW_FIR_Q15(fir_q15_max, fir_max_q15, 4);
+NEW_FIR_Q31(fir_q31_5, fir_coeffs_q31, 5);
+
+static uint32_t fir_seed = 12345;
+
+static int32_t firTestRandom(void) {
+    fir_seed = (fir_seed * 1103515245) + 12345;
+    return ((int32_t) fir_seed);
+}
+
+/* filter pseudo-random samples in blocks of increasing size and compare to direct convolution */
+static bool testFirQ15(fir_t * fir, const q15_t * h) {
+    q15_t   x[FIR_TEST_SAMPLES], y[FIR_TEST_SAMPLES];
+    bool    pass = true;
+
+    for (int i=0; i<FIR_TEST_SAMPLES; ++i) { x[i] = (q15_t) (firTestRandom() >> 16); }
+    for (int i=0, n=0; i<FIR_TEST_SAMPLES; i+=n) {
+        n = MIN(n + 1, FIR_TEST_SAMPLES - i);
+        firProcess(fir, &x[i], &y[i], n);
+    }
+    for (int i=0; i<FIR_TEST_SAMPLES; ++i) {
+        int64_t acc = 0;
+        for (int k=0; (k<(int) fir->taps) && (k<=i); ++k) { acc += (int32_t) h[k] * x[i-k]; }
+        pass &= (y[i] == dspSatQ15(acc));
+    }
+    return (pass);
+}
+
+static bool testFirQ31(fir_t * fir, const q31_t * h) {
+    q31_t   x[FIR_TEST_SAMPLES], y[FIR_TEST_SAMPLES];
+    bool    pass = true;
+
+    for (int i=0; i<FIR_TEST_SAMPLES; ++i) { x[i] = firTestRandom(); }
+    for (int i=0, n=0; i<FIR_TEST_SAMPLES; i+=n) {
+        n = MIN(n + 1, FIR_TEST_SAMPLES - i);
+        firProcess(fir, &x[i], &y[i], n);
+    }
+    for (int i=0; i<FIR_TEST_SAMPLES; ++i) {
+        int64_t acc = 0;
+        for (int k=0; (k<(int) fir->taps) && (k<=i); ++k) { acc += (int64_t) h[k] * x[i-k]; }
+        pass &= (y[i] == dspSatQ31(acc));
+    }
+    return (pass);
+}
+
+
+int fir_UNIT_TEST(void) {
+    bool  pass = true;
+    q15_t x[9], y[9];
+
+    pass &= testFirQ15(fir_q15_9, fir_coeffs_q15);
+    pass &= testFirQ15(fir_q15_8, fir_coeffs_q15);
+    pass &= testFirQ15(fir_q15_1, fir_coeffs_q15);
+    pass &= testFirQ31(fir_q31_5, fir_coeffs_q31);
+
+    /* impulse response is the coefficients, processed in place */
+    memset(x, 0, sizeof(x));
+    x[0] = INT16_MAX;
+    firProcess(fir_q15_9, x, x, 9);             // flush the history with the impulse
+    memset(y, 0, sizeof(y));
+    y[0] = INT16_MIN;                           // -1.0
+    firProcess(fir_q15_9, y, y, 9);
+    for (int i=0; i<9; ++i) { pass &= (y[i] == -fir_coeffs_q15[i]); }
+
+    /* saturation */
+    for (int i=0; i<4; ++i) { x[i] = INT16_MAX; y[i] = INT16_MIN; }
+    firProcess(fir_q15_max, x, x, 4);
+    pass &= (x[0] == 32766) && (x[1] == INT16_MAX) && (x[3] == INT16_MAX);
+    firProcess(fir_q15_max, y, y, 4);
+    pass &= (y[3] == INT16_MIN);
+
+    return ((int) !pass);
+}
+
+
+/* decimator and interpolator outputs match a full rate FIR of the same coefficients */
+NEW_DECIMATOR(dec_q15_9_4, q15_t, fir_coeffs_q15, 9, 4);
+NEW_FIR_Q15(dec_ref_q15_9, fir_coeffs_q15, 9);
+NEW_DECIMATOR(dec_q31_5_16, q31_t, fir_coeffs_q31, 5, 16);
+NEW_FIR_Q31(dec_ref_q31_5, fir_coeffs_q31, 5);
+NEW_DECIMATOR(dec_q15_1_1, q15_t, fir_coeffs_q15, 1, 1);
+
+NEW_INTERPOLATOR(interp_q15_9_3, q15_t, fir_coeffs_q15, 9, 3);
+NEW_FIR_Q15(interp_ref_q15_9, fir_coeffs_q15, 9);
+NEW_INTERPOLATOR(interp_q31_5_2, q31_t, fir_coeffs_q31, 5, 2);     // taps not a multiple of L
+NEW_FIR_Q31(interp_ref_q31_5, fir_coeffs_q31, 5);
+
+#define DEC_TEST_SAMPLES    100
+
+static bool testDecimator(decimator_t * dec, fir_t * ref) {
+    q31_t       x[DEC_TEST_SAMPLES], y[DEC_TEST_SAMPLES], y_ref[DEC_TEST_SAMPLES];
+    size_t      size = (dec->format == FIR_Q15) ? sizeof(q15_t) : sizeof(q31_t);
+    uint32_t    outputs = 0;
+    bool        pass = true;
+
+    for (int i=0; i<DEC_TEST_SAMPLES; ++i) { x[i] = firTestRandom(); }
+    firProcess(ref, x, y_ref, DEC_TEST_SAMPLES);
+    for (int i=0, n=0; i<DEC_TEST_SAMPLES; i+=n) {             // blocks shorter and longer than M
+        n = MIN(n + 3, DEC_TEST_SAMPLES - i);
+        outputs += decimProcess(dec, (char *) x + (i * size), (char *) y + (outputs * size), n);
+    }
+    pass &= (outputs == (uint32_t) ((DEC_TEST_SAMPLES + dec->factor - 1) / dec->factor));
+    for (uint32_t i=0; i<outputs; ++i) {
+        if (dec->format == FIR_Q15) { pass &= (((q15_t *) y)[i] == ((q15_t *) y_ref)[i * dec->factor]); }
+        else                        { pass &= (y[i] == y_ref[i * dec->factor]); }
+    }
+    return (pass);
+}
+
+static bool testInterpolator(interpolator_t * interp, fir_t * ref) {
+    q31_t       x[DEC_TEST_SAMPLES / 4], y[DEC_TEST_SAMPLES], y_ref[DEC_TEST_SAMPLES];
+    mem_index_t L = interp->factor;
+    uint32_t    n = DEC_TEST_SAMPLES / 4;
+    bool        pass = true;
+
+    for (uint32_t i=0; i<n; ++i) { x[i] = firTestRandom(); }
+    memset(y_ref, 0, sizeof(y_ref));
+    for (uint32_t i=0; i<n; ++i) {                            // zero stuffed input
+        if (interp->format == FIR_Q15) { ((q15_t *) y_ref)[i * L] = ((q15_t *) x)[i]; }
+        else                           { y_ref[i * L] = x[i]; }
+    }
+    firProcess(ref, y_ref, y_ref, n * L);
+    interpProcess(interp, x, y, 1);
+    if (interp->format == FIR_Q15) { interpProcess(interp, (q15_t *) x + 1, (q15_t *) y + L, n - 1); }
+    else                           { interpProcess(interp, x + 1, y + L, n - 1); }
+    pass &= (memcmp(y, y_ref, n * L * ((interp->format == FIR_Q15) ? sizeof(q15_t) : sizeof(q31_t))) == 0);
+    return (pass);
+}
+
+
+int decimator_UNIT_TEST(void) {
+    bool  pass = true;
+
+    pass &= testDecimator(dec_q15_9_4, dec_ref_q15_9);
+    pass &= testDecimator(dec_q31_5_16, dec_ref_q31_5);
+    pass &= testDecimator(dec_q15_1_1, fir_q15_1);             // M of 1 is the FIR
+
+    pass &= testInterpolator(interp_q15_9_3, interp_ref_q15_9);
+    pass &= testInterpolator(interp_q31_5_2, interp_ref_q31_5);
+
+    return ((int) !pass);
+}
+
+
+/* CIC outputs match the decimated convolution with the N times convolved boxcar of R */
+NEW_CIC(cic_3_8, 3, 8, 16);
+NEW_CIC(cic_4_5, 4, 5, 16);                                    // gain not a power of two
+NEW_CIC(cic_4_16, 4, 16, 16);                                  // all 32 bits used
+NEW_CIC(cic_pdm, 4, 64, 2);
+
+static const q15_t cic_droop[3] = { -3000, 20000, -3000 };
+NEW_FIR_Q15(cic_fir, cic_droop, 3);
+NEW_FIR_Q15(cic_fir_ref, cic_droop, 3);
+NEW_CIC_COMPENSATED(cic_comp, 3, 8, 16, cic_fir);
+NEW_CIC(cic_comp_ref, 3, 8, 16);
+
+#define CIC_TEST_SAMPLES    400
+#define CIC_KERNEL_MAX      64          // N * (R - 1) + 1 of the largest filter tested
+
+static bool testCic(cic_t * cic) {
+    q15_t       x[CIC_TEST_SAMPLES], y[CIC_TEST_SAMPLES];
+    int64_t     kernel[CIC_KERNEL_MAX] = { 1 }, next[CIC_KERNEL_MAX];
+    int         len = 1, bits = 16;
+    uint64_t    gain = 1;
+    uint32_t    outputs = 0;
+    bool        pass = true;
+
+    for (int s=0; s<cic->order; ++s) {                         // kernel of R^N, length N * (R - 1) + 1
+        memset(next, 0, sizeof(next));
+        for (int i=0; i<len; ++i) {
+            for (int j=0; j<(int) cic->rate; ++j) { next[i + j] += kernel[i]; }
+        }
+        len += cic->rate - 1;
+        memcpy(kernel, next, sizeof(kernel));
+        gain *= cic->rate;
+    }
+    while (((uint64_t) 1 << (bits - 16)) < gain) { ++bits; }
+
+    for (int i=0; i<CIC_TEST_SAMPLES; ++i) { x[i] = (q15_t) (firTestRandom() >> 16); }
+    for (int i=0, n=0; i<CIC_TEST_SAMPLES; i+=n) {
+        n = MIN(n + 5, CIC_TEST_SAMPLES - i);
+        outputs += cicProcess(cic, &x[i], &y[outputs], n);
+    }
+    pass &= (outputs == (uint32_t) ((CIC_TEST_SAMPLES + cic->rate - 1) / cic->rate));
+    for (uint32_t m=0; m<outputs; ++m) {
+        int64_t acc = 0;
+        for (int k=0; (k<len) && (k<=(int) (m * cic->rate)); ++k) { acc += kernel[k] * x[(m * cic->rate) - k]; }
+        pass &= (y[m] == (q15_t) (acc >> (bits - 16)));
+    }
+    return (pass);
+}
+
+
+int cic_UNIT_TEST(void) {
+    bool      pass = true;
+    q15_t     x[CIC_TEST_SAMPLES], y[CIC_TEST_SAMPLES], y_ref[CIC_TEST_SAMPLES];
+    uint32_t  outputs;
+
+    pass &= testCic(cic_3_8);
+    pass &= testCic(cic_4_5);
+    pass &= testCic(cic_4_16);
+
+    /* dc gain of one when R^N is a power of two, the integrators wrap many times */
+    for (int i=0; i<CIC_TEST_SAMPLES; ++i) { x[i] = -20000; }
+    for (int i=0; i<10; ++i) { outputs = cicProcess(cic_4_16, x, y, CIC_TEST_SAMPLES); }
+    pass &= (outputs == CIC_TEST_SAMPLES / 16) && (y[0] == -20000) && (y[outputs - 1] == -20000);
+
+    /* +1/-1 samples, full scale in is half scale out, a tone at half the input rate is removed */
+    for (int i=0; i<CIC_TEST_SAMPLES; ++i) { x[i] = 1; }
+    (void) cicProcess(cic_pdm, x, y, CIC_TEST_SAMPLES);
+    outputs = cicProcess(cic_pdm, x, y, CIC_TEST_SAMPLES);
+    pass &= (y[outputs - 1] == 16384);
+    for (int i=0; i<CIC_TEST_SAMPLES; ++i) { x[i] = (i & 1) ? 1 : -1; }
+    (void) cicProcess(cic_pdm, x, y, CIC_TEST_SAMPLES);
+    outputs = cicProcess(cic_pdm, x, y, CIC_TEST_SAMPLES);
+    pass &= (y[0] == 0) && (y[outputs - 1] == 0);
+
+    /* compensated output is the CIC output filtered by the FIR */
+    for (int i=0; i<CIC_TEST_SAMPLES; ++i) { x[i] = (q15_t) (firTestRandom() >> 16); }
+    outputs = cicProcess(cic_comp_ref, x, y_ref, CIC_TEST_SAMPLES);
+    firProcess(cic_fir_ref, y_ref, y_ref, outputs);
+    pass &= (cicProcess(cic_comp, x, y, CIC_TEST_SAMPLES) == outputs);
+    pass &= (memcmp(y, y_ref, outputs * sizeof(q15_t)) == 0);
+
+    return ((int) !pass);
+}
+
+#endif  /* UNIT_TEST */
@@ -0,0 +1,240 @@
+/*****************************************************************************
+
+      (c) Copyright 2016 DDPA LLC
+      ALL RIGHTS RESERVED.
+
+    dsp.h - Fixed point filters built on the DL delay line of memory.h.
+
+ *****************************************************************************/
+
+#ifndef _dsp_H_
+#define _dsp_H_
+
+#include  <stdint.h>
+#include  "memory.h"
+
+
+/*
+ * DSP_SIMD selects the kernels that use the Cortex-M4 dual 16 bit multiply
+ * accumulate instructions. The portable C kernels are used on the CM0/CM0+,
+ * the CM3 and the host. Define DSP_SIMD as 0 or 1 to override.
+ */
+#ifndef DSP_SIMD
+  #if defined (__CORTEX_M) && (__CORTEX_M == 4)
+    #define DSP_SIMD    1
+  #else
+    #define DSP_SIMD    0
+  #endif
+#endif
+
+
+typedef int16_t   q15_t;      // fixed point 1.15, -1.0 <= x < 1.0
+typedef int32_t   q31_t;      // fixed point 1.31, -1.0 <= x < 1.0
+
+
+/*****************************************************************************
+
+   FIR: A fixed point finite impulse response filter with block processing.
+
+        Usage Example:
+        static const q15_t lowpass[32] = { ... };
+        NEW_FIR_Q15(adc_filter, lowpass, 32);
+        firProcess(adc_filter, adc_samples, filtered, n);
+
+        y[n] = coeffs[0] * x[n] + coeffs[1] * x[n-1] + ... + coeffs[taps-1] * x[n-taps+1]
+
+        The filter history is a mirrored delay line of taps samples, so each
+        output is one convolution of the contiguous dlWindow() with the
+        coefficients. The history persists from one call of firProcess() to
+        the next, so a stream may be processed in blocks of any size.
+
+        Products are summed in 64 bits and the result is truncated and
+        saturated to the output format. A Q31 filter cannot overflow the
+        accumulator if the sum of the coefficient magnitudes is less than 2.0.
+
+        On the Cortex-M4 the Q15 kernel multiplies two taps per instruction
+        with __SMLALD. The Q31 kernel is C on every processor, the compiler
+        uses SMLAL on the CM3/CM4.
+
+        The coefficients are not copied and must remain valid for the life
+        of the filter. A filter may be processed from one context at a time.
+
+   Revision History:
+    10/16/26  Initial release
+
+ *****************************************************************************/
+
+typedef enum {
+    FIR_Q15,
+    FIR_Q31,
+} fir_format_t;
+
+typedef struct {
+    const fir_format_t  format;
+    const mem_index_t   taps;
+    const void * const  coeffs;     // coeffs[0] multiplies the newest sample
+    void * const        dl;         // mirrored delay line of taps samples
+} fir_t;
+
+/*
+ * Macros to create a filter of taps coefficients
+ */
+#define NEW_FIR_Q15(name, coeffs, taps)                                       \
+NEW_MIRRORED_DELAY_LINE(name##_dl, q15_t, taps)                               \
+static fir_t name##_obj = { FIR_Q15, taps, coeffs, &name##_dl_obj };          \
+fir_t * const name = &name##_obj;
+
+#define NEW_FIR_Q31(name, coeffs, taps)                                       \
+NEW_MIRRORED_DELAY_LINE(name##_dl, q31_t, taps)                               \
+static fir_t name##_obj = { FIR_Q31, taps, coeffs, &name##_dl_obj };          \
+fir_t * const name = &name##_obj;
+
+
+void      firProcess(fir_t * fir, const void * in, void * out, uint32_t n);   // filter n samples of in to out
+
+
+
+/*****************************************************************************
+
+   DECIMATOR: A polyphase FIR decimator, one output for every M inputs.
+
+   INTERPOLATOR: A polyphase FIR interpolator, L outputs for every input.
+
+        Usage Example:
+        static const q15_t antialias[64] = { ... };
+        NEW_DECIMATOR(log_filter, q15_t, antialias, 64, 16);
+        n_out = decimProcess(log_filter, dma_block, logged, 256);
+
+        NEW_INTERPOLATOR(dac_filter, q31_t, image_reject, 48, 4);
+        interpProcess(dac_filter, samples, dac_block, 32);    // 128 outputs
+
+        The type is q15_t or q31_t. The output is the same as filtering
+        at the high rate with the taps coefficients, as with firProcess,
+        and keeping every Mth output (decimator) or filtering the input with
+        L - 1 zeros inserted after every sample (interpolator). The first
+        input produces the first output of the decimator.
+
+        Only the outputs that are kept are computed. The decimator inserts
+        the M inputs between outputs with one dlUpdateN() and computes one
+        convolution of taps, 1/M of the multiply accumulates of a full rate
+        filter. The interpolator computes each output phase from the
+        taps / L coefficients that meet a non-zero input, 1/L of the work
+        of filtering the zero stuffed input. Its coefficients should have a
+        gain of L to preserve the signal level.
+
+        The decimator and Q15 kernels are those of the FIR, the
+        interpolator reads its coefficients with a stride of L and is C on
+        every processor.
+
+   Revision History:
+    10/16/26  Initial release
+
+ *****************************************************************************/
+
+typedef struct {
+    const fir_format_t  format;
+    const mem_index_t   taps;
+    const mem_index_t   factor;     // M
+    mem_index_t         phase;      // inputs to the next output
+    const void * const  coeffs;
+    void * const        dl;         // mirrored delay line of taps samples
+} decimator_t;
+
+typedef struct {
+    const fir_format_t  format;
+    const mem_index_t   taps;
+    const mem_index_t   factor;     // L
+    const void * const  coeffs;
+    void * const        dl;         // mirrored delay line of taps / L samples, rounded up
+} interpolator_t;
+
+#define DSP_FORMAT(type)    ((sizeof(type) == sizeof(q15_t)) ? FIR_Q15 : FIR_Q31)
+
+/*
+ * Macros to create a decimator by M or an interpolator by L
+ */
+#define NEW_DECIMATOR(name, type, coeffs, taps, M)                                           \
+NEW_MIRRORED_DELAY_LINE(name##_dl, type, taps)                                               \
+static decimator_t name##_obj = { DSP_FORMAT(type), taps, M, 1, coeffs, &name##_dl_obj };    \
+decimator_t * const name = &name##_obj;                                                      \
+STATIC_ASSERT(((sizeof(type) == sizeof(q15_t)) || (sizeof(type) == sizeof(q31_t))) && ((M) > 0));
+
+#define NEW_INTERPOLATOR(name, type, coeffs, taps, L)                                        \
+NEW_MIRRORED_DELAY_LINE(name##_dl, type, ((taps) + (L) - 1) / (L))                           \
+static interpolator_t name##_obj = { DSP_FORMAT(type), taps, L, coeffs, &name##_dl_obj };    \
+interpolator_t * const name = &name##_obj;                                                   \
+STATIC_ASSERT(((sizeof(type) == sizeof(q15_t)) || (sizeof(type) == sizeof(q31_t))) && ((L) > 0));
+
+
+uint32_t  decimProcess(decimator_t * dec, const void * in, void * out, uint32_t n);      // n inputs, returns the number of outputs
+void      interpProcess(interpolator_t * interp, const void * in, void * out, uint32_t n);  // n inputs, n * L outputs
+
+
+
+/*****************************************************************************
+
+   CIC: A cascaded integrator-comb decimator by R of order N.
+
+        Usage Example:
+        NEW_CIC(pdm_cic, 4, 64, 2);                        // +1/-1 PDM samples
+        n_out = cicProcess(pdm_cic, pdm_samples, pcm, 1024);
+
+        NEW_FIR_Q15(droop, droop_coeffs, 7);
+        NEW_CIC_COMPENSATED(adc_cic, 3, 8, 16, droop);     // q15 ADC samples
+        n_out = cicProcess(adc_cic, adc_block, filtered, 256);
+        dlUpdateN(history, filtered, n_out);
+
+        The CIC has no multiplies. Each input is added through N integrators
+        and each output is differenced through N combs of one output delay.
+        The gain of the filter is R^N. The integrators and combs are
+        uint32_t that wrap, which gives the exact result as long as the
+        output fits in 32 bits: input_bits + log2(R^N) <= 32. input_bits is
+        the signed width of the input samples, 16 for q15_t or 2 for
+        samples of +1 and -1.
+
+        The output is q15_t, scaled by 2^-(input_bits + ceil(log2(R^N)) - 16)
+        so that a full scale input is a full scale output when R^N is a
+        power of two, and less otherwise. The first input produces the
+        first output, as for the decimator.
+
+        The passband droop of the CIC is corrected by a short Q15 FIR of
+        coefficients designed for N and R at the output rate. The output
+        block of NEW_CIC_COMPENSATED is filtered with firProcess() before
+        it is returned.
+
+   Revision History:
+    10/16/26  Initial release
+
+ *****************************************************************************/
+
+#define CIC_ORDER_MAX   6
+
+typedef struct {
+    const uint8_t       order;        // N
+    const uint8_t       input_bits;
+    const mem_index_t   rate;         // R
+    mem_index_t         phase;        // inputs to the next output
+    uint32_t * const    state;        // N integrators followed by N comb delays
+    fir_t * const       compensator;  // NULL if none
+} cic_t;
+
+/*
+ * Macros to create a CIC decimator, with or without a compensating FIR
+ */
+#define NEW_CIC(name, order, rate, input_bits)                                                \
+static uint32_t name##_state[2 * (order)];                                                    \
+static cic_t name##_obj = { order, input_bits, rate, 1, name##_state, NULL };                 \
+cic_t * const name = &name##_obj;                                                             \
+STATIC_ASSERT(((order) > 0) && ((order) <= CIC_ORDER_MAX) && ((rate) > 0) && ((input_bits) > 1) && ((input_bits) <= 16));
+
+#define NEW_CIC_COMPENSATED(name, order, rate, input_bits, fir)                               \
+static uint32_t name##_state[2 * (order)];                                                    \
+static cic_t name##_obj = { order, input_bits, rate, 1, name##_state, &fir##_obj };           \
+cic_t * const name = &name##_obj;                                                             \
+STATIC_ASSERT(((order) > 0) && ((order) <= CIC_ORDER_MAX) && ((rate) > 0) && ((input_bits) > 1) && ((input_bits) <= 16));
+
+
+uint32_t  cicProcess(cic_t * cic, const q15_t * in, q15_t * out, uint32_t n);   // n inputs, returns the number of outputs
+
+
+#endif  /* _dsp_H_ */
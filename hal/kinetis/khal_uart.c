@@ -33,10 +33,10 @@ static void _LPUART_IRQHandler(LPUART_MemMapPtr uart);
 #endif
 
 #ifdef KHAL_LPUART_INSTALL_IRQ_HANDLER_LPUART0
-    NEW_FIFO(khal_lpuart_tx_buf_lpuart0, KHAL_LPUART_TX_FIFO_SIZE_LPUART0);
-    NEW_FIFO(khal_lpuart_rx_buf_lpuart0, KHAL_LPUART_RX_FIFO_SIZE_LPUART0);
-    #define khal_lpuart_tx_buf_lpuart0_ptr  &khal_lpuart_tx_buf_lpuart0
-    #define khal_lpuart_rx_buf_lpuart0_ptr  &khal_lpuart_rx_buf_lpuart0
+    NEW_SPSC_FIFO(khal_lpuart_tx_buf_lpuart0, KHAL_LPUART_TX_FIFO_SIZE_LPUART0);
+    NEW_SPSC_FIFO(khal_lpuart_rx_buf_lpuart0, KHAL_LPUART_RX_FIFO_SIZE_LPUART0);
+    #define khal_lpuart_tx_buf_lpuart0_ptr  khal_lpuart_tx_buf_lpuart0
+    #define khal_lpuart_rx_buf_lpuart0_ptr  khal_lpuart_rx_buf_lpuart0
     void LPUART0_IRQHandler(void) { _LPUART_IRQHandler(LPUART0); }
 #else
     #define khal_lpuart_tx_buf_lpuart0_ptr  (NULL)
@@ -44,10 +44,10 @@ static void _LPUART_IRQHandler(LPUART_MemMapPtr uart);
 #endif  /* KHAL_LPUART_INSTALL_IRQ_HANDLER_LPUART0 */
 
 #ifdef KHAL_LPUART_INSTALL_IRQ_HANDLER_LPUART1
-    NEW_FIFO(khal_lpuart_tx_buf_lpuart1, KHAL_LPUART_TX_FIFO_SIZE_LPUART1);
-    NEW_FIFO(khal_lpuart_rx_buf_lpuart1, KHAL_LPUART_RX_FIFO_SIZE_LPUART1);
-    #define khal_lpuart_tx_buf_lpuart1_ptr  &khal_lpuart_tx_buf_lpuart1
-    #define khal_lpuart_rx_buf_lpuart1_ptr  &khal_lpuart_rx_buf_lpuart1
+    NEW_SPSC_FIFO(khal_lpuart_tx_buf_lpuart1, KHAL_LPUART_TX_FIFO_SIZE_LPUART1);
+    NEW_SPSC_FIFO(khal_lpuart_rx_buf_lpuart1, KHAL_LPUART_RX_FIFO_SIZE_LPUART1);
+    #define khal_lpuart_tx_buf_lpuart1_ptr  khal_lpuart_tx_buf_lpuart1
+    #define khal_lpuart_rx_buf_lpuart1_ptr  khal_lpuart_rx_buf_lpuart1
     void LPUART0_IRQHandler(void) { _LPUART_IRQHandler(LPUART1); }
 #else
     #define khal_lpuart_tx_buf_lpuart1_ptr  (NULL)
@@ -160,7 +160,7 @@ char khal_lpuart_GetChar(LPUART_MemMapPtr uart) {
 bool khal_lpuart_PutFifo(LPUART_MemMapPtr uart, char *str) {
     bool rslt= true;
 
-    if (strlen(str) > fifoRemaining(KHAL_LPUART_TX_BUF_PTR(uart))) { return (false); }
+    if (strlen(str) > fifoSpscRemaining(KHAL_LPUART_TX_BUF_PTR(uart))) { return (false); }
 
     while (*str) {
         if (uart->STAT & LPUART_STAT_TC_MASK) {
@@ -168,7 +168,7 @@ bool khal_lpuart_PutFifo(LPUART_MemMapPtr uart, char *str) {
             uart->CTRL |= LPUART_CTRL_TIE_MASK;
         }
         else {
-            rslt &= fifoPush((TFifo) KHAL_LPUART_TX_BUF_PTR(uart), *str);
+            rslt &= fifoSpscPush(KHAL_LPUART_TX_BUF_PTR(uart), *str);
         }
         ++str;
     }
@@ -176,14 +176,15 @@ bool khal_lpuart_PutFifo(LPUART_MemMapPtr uart, char *str) {
 }
 
 bool khal_lpuart_GetFifo(LPUART_MemMapPtr uart, char *c) {
-    return (fifoPop((TFifo) KHAL_LPUART_RX_BUF_PTR(uart), c));
+    return (fifoSpscPop(KHAL_LPUART_RX_BUF_PTR(uart), c));
 }
 
+/* the irq handler is the tx fifo consumer and the rx fifo producer, it never masks interrupts */
 static void _LPUART_IRQHandler(LPUART_MemMapPtr uart) {
     char c;
 
     if (uart->STAT & LPUART_STAT_TDRE_MASK) {
-        if (fifoPop((TFifo) KHAL_LPUART_TX_BUF_PTR(uart), &c) ){
+        if (fifoSpscPop(KHAL_LPUART_TX_BUF_PTR(uart), &c) ){
             uart->DATA = (uint32_t) c;
         }
         else {
@@ -192,7 +193,7 @@ static void _LPUART_IRQHandler(LPUART_MemMapPtr uart) {
     }
     if (uart->STAT & LPUART_STAT_RDRF_MASK) {
         c = (char) (uart->DATA & 0x000000ff);
-        fifoPush((TFifo) KHAL_LPUART_RX_BUF_PTR(uart), c);
+        fifoSpscPush(KHAL_LPUART_RX_BUF_PTR(uart), c);
     }
 }
 
@@ -32,14 +32,15 @@ typedef enum khal_lpuart_br_clk_src_t {
 
 
 /* defining KHAL_LPUART_INSTALL_IRQ_HANDLER_LPUARTx instantiates tx and rx fifos and uses the default irq handler */
+/* the fifos are lock-free SPSC fifos, sizes must be powers of two */
 #define KHAL_LPUART_INSTALL_IRQ_HANDLER_LPUART0
-#define KHAL_LPUART_TX_FIFO_SIZE_LPUART0              40
-#define KHAL_LPUART_RX_FIFO_SIZE_LPUART0              40
+#define KHAL_LPUART_TX_FIFO_SIZE_LPUART0              64
+#define KHAL_LPUART_RX_FIFO_SIZE_LPUART0              64
 
 #define KHAL_LPUART_INSTALL_IRQ_HANDLER_LPUART1
 #undef  KHAL_LPUART_INSTALL_IRQ_HANDLER_LPUART1
-#define KHAL_LPUART_TX_FIFO_SIZE_LPUART1              40
-#define KHAL_LPUART_RX_FIFO_SIZE_LPUART1              40
+#define KHAL_LPUART_TX_FIFO_SIZE_LPUART1              64
+#define KHAL_LPUART_RX_FIFO_SIZE_LPUART1              64
 
 
 
@@ -20,8 +20,10 @@
 
  *****************************************************************************/
 
-#include  "bitvector.h"
+#include  <string.h>
+#include  "cpu.h"
 #include  "dbc.h"
+#include  "bitvector.h"
 #include  "memory.h"
 
 
@@ -29,230 +31,773 @@
 
    POOL: A thread-safe malloc alternative that allocates fixed sized blocks.
 
-       The total number of blocks is limited to 64.
+       The number of blocks in each partition is limited to 1024.
        The maximum allocation block size is 1024 bytes.
-       The number and size of allocation blocks are optimized to each application
-           using the #define POOL_PARTITION_xx_BLOCKS macros.
+       The block size of each partition is a size class set at compile time
+           with the #define POOL_CLASS_n macros, powers of two by default.
+       The number of blocks of each class is optimized to each pool
+           with the partition spec passed to NEW_POOL.
 
        Definitions:
            POOL - the entire statically allocated memory area, including overhead.
-           PARTITION - A subset of the pool containing equally sized blocks in
-                       power-of-two increments.
-           BLOCK - A single power-of-two sized allocatable section of a partition
+           PARTITION - A subset of the pool containing equally sized blocks of
+                       one size class.
+           BLOCK - A single class sized allocatable section of a partition
 
-        A call to poolMalloc(size) will attempt to allocate the smallest power-of-two
+        A call to poolMalloc(size) will attempt to allocate the smallest class
         block available that will hold size bytes. In the pathological case an attempt
         to allocate 1 byte may use a 1024 byte block.
 
-        Bit field organization
-         PBMax    blks-1                           1     0
-        ----------------------------------------------------
-        | unused |  8   | .. | 16 | .. |         | .. |1024|
-        ----------------------------------------------------
+        Allocation bitmap organization
+        The allocated/free state of a pool is kept in a three level bitmap
+        so that a free block is found with three CLZ operations regardless
+        of the number of blocks in the pool.
+
+          full              bit p set if every block in partition p is allocated
+
+          summary[p]        bit l set if every block in allocation word l of
+                            partition p is allocated
+
+          leaf[]            bit b of a word set if the block is allocated,
+                            one or more words per partition
+
+        Bits in the last word of a partition that do not correspond to a block
+        are never set. A word is full when all of its valid bits are set.
+
+        Lockless operation
+        A block is owned by whoever sets its leaf bit with a successful cpuCAS.
+        The summary and full bits are hints that let a search skip full words
+        and partitions. A hint is set only after the level below it is seen
+        to be full, and is re-checked after setting so that a concurrent free
+        cannot leave it set over a free block. poolFree clears the leaf bit
+        first, then the hints, so after any free completes its word and
+        partition are marked as having a free block. A hint that is clear
+        over a full word only costs a retry.
+
+        Buddy pools
+        A buddy pool allocates from the best fit size in order: a free half
+        of that size, a native block of the partition, then the same from
+        the next larger size, splitting the block found down to the best fit.
+        Each split marks the block in split[s] and its upper half free in
+        half[s/2]. The lower half is split again or returned. Because
+        partitions are naturally aligned, the block of size s containing a
+        byte offset is offset >> log2(s) in every bit vector, and the buddy of
+        a block is that index ^ 1. poolFree descends from the native partition
+        of the address through the split blocks to the allocated size, then
+        merges with free buddies on the way back up. Split and merge touch
+        several bit vectors, so buddy pools run under LOCK. Native blocks are
+        still claimed with the lockless allocation bitmap.
+
+        Size classes
+        The best fit class of a request is read from a 256 entry table indexed
+        by (size - 1) / 4, built at compile time from the POOL_CLASS_n macros.
+        Block addresses are computed with a multiply by the class size, and
+        addresses are translated back to block numbers with a multiply by a
+        precomputed 32 bit reciprocal of the class size instead of a divide.
+
+        Timing
+        With POOL_TIMING defined poolMalloc and poolFree read the cycle
+        counter on entry and exit and fold the difference into the min, max
+        and total of the pool with CAS updates. The counter is DWT->CYCCNT on
+        M3/M4, enabled by the first timed call, and the SysTick down counter
+        on M0/M0+, whose elapsed count is taken modulo its period of LOAD + 1
+        so that it may also be the system tick. POOL_CYCLES and
+        POOL_CYCLES_MASK may be defined to use another free running counter.
 
    Revision History:
     09/09/16  Initial release
+    10/16/26  Block/address translation from compile-time partition tables
+    10/16/26  Two-level summary/leaf allocation bitmap, constant time malloc and free
+    10/16/26  Instance pools created with NEW_POOL, the default pool is g_pool
+    10/16/26  Lockless malloc and free using cpuCAS, lockless statistics and history
+    10/16/26  Buddy split/coalesce pools
+    10/16/26  Compile-time size class table and best fit lookup
+    10/16/26  Text dump of pool statistics and history
+    10/16/26  Requested bytes and malloc/free cycle timing
+    10/16/26  poolRealloc, in place when the block still fits
+    10/16/26  SysTick timing modulo its reload, DWT cycle counter enabled on first use
 
  *****************************************************************************/
 
-/*
- * When allocating memory, all partitions smaller than the requested size
- * are masked (as if they were allocated) to allow FF1 to find the first
- * block equal to or larger than the requested size.
- */
-#define POOL_PARTITION_MASK_1024    ((uint64_t) (0xffffffffffffffff       << POOL_PARTITION_1024_BLOCKS))
-#define POOL_PARTITION_MASK_512     ((uint64_t) (POOL_PARTITION_MASK_1024 << POOL_PARTITION_512_BLOCKS))
-#define POOL_PARTITION_MASK_256     ((uint64_t) (POOL_PARTITION_MASK_512  << POOL_PARTITION_256_BLOCKS))
-#define POOL_PARTITION_MASK_128     ((uint64_t) (POOL_PARTITION_MASK_256  << POOL_PARTITION_128_BLOCKS))
-#define POOL_PARTITION_MASK_64      ((uint64_t) (POOL_PARTITION_MASK_128  << POOL_PARTITION_64_BLOCKS))
-#define POOL_PARTITION_MASK_32      ((uint64_t) (POOL_PARTITION_MASK_64   << POOL_PARTITION_32_BLOCKS))
-#define POOL_PARTITION_MASK_16      ((uint64_t) (POOL_PARTITION_MASK_32   << POOL_PARTITION_16_BLOCKS))
-#define POOL_PARTITION_MASK_8       ((uint64_t) (POOL_PARTITION_MASK_16   << POOL_PARTITION_8_BLOCKS))
+#define POOL_PARTITION_SHIFT(p)     ((p) + 3)     // log2 of the block size of partition index p, buddy pools only
 
-const uint64_t  g_partition_mask[POOL_PARTITIONS] = { POOL_PARTITION_MASK_8,   POOL_PARTITION_MASK_16,  POOL_PARTITION_MASK_32,  POOL_PARTITION_MASK_64,
-                                                      POOL_PARTITION_MASK_128, POOL_PARTITION_MASK_256, POOL_PARTITION_MASK_512, POOL_PARTITION_MASK_1024 };
-
-const uint8_t   g_pool_blocks[POOL_PARTITIONS] = { POOL_PARTITION_8_BLOCKS,   POOL_PARTITION_16_BLOCKS,  POOL_PARTITION_32_BLOCKS,  POOL_PARTITION_64_BLOCKS,
-                                                   POOL_PARTITION_128_BLOCKS, POOL_PARTITION_256_BLOCKS, POOL_PARTITION_512_BLOCKS, POOL_PARTITION_1024_BLOCKS };
+#define POOL_MASK(n)                (((n) >= 32) ? 0xffffffff : ((1UL << (n)) - 1))   // n least significant bits set
+#define POOL_LSB(x)                 (31 - cpuCLZ((x) & (0 - (x))))                    // position of least significant one, -1 if none
 
 #define POOL_HISTORY_ALLOC          0x8000
 #define POOL_HISTORY_FREE           0x0000
 
-#define POOL_SIZE   ((1024 * POOL_PARTITION_1024_BLOCKS) + (512 * POOL_PARTITION_512_BLOCKS) + (256 * POOL_PARTITION_256_BLOCKS) + (128 * POOL_PARTITION_128_BLOCKS) +  \
-                     (64 * POOL_PARTITION_64_BLOCKS)     + (32 * POOL_PARTITION_32_BLOCKS)   + (16 * POOL_PARTITION_16_BLOCKS)   + (8 * POOL_PARTITION_8_BLOCKS))
+STATIC_ASSERT(!(POOL_HISTORY_DEPTH & (POOL_HISTORY_DEPTH - 1)));   // history index wraps with the counter
+
+#if defined (POOL_TIMING) && !defined (POOL_CYCLES)
+    #if defined (UNIT_TEST)
+        static uint32_t pool_test_cycles;                                   // every read is 7 cycles later
+        #define POOL_CYCLES()       (pool_test_cycles += 7)
+        #define POOL_ELAPSED(start) (POOL_CYCLES() - (start))
+    #elif (__CORTEX_M == 0)
+        #define POOL_CYCLES()       (SysTick->VAL)                          // counts down from LOAD to 0
+        #define POOL_ELAPSED(start) poolSysTickElapsed(start)
+    #else
+        #define POOL_CYCLES()       poolCycleCounter()
+        #define POOL_ELAPSED(start) (POOL_CYCLES() - (start))
+    #endif
+#elif defined (POOL_TIMING)
+    #define POOL_ELAPSED(start)     ((POOL_CYCLES() - (start)) & POOL_CYCLES_MASK)
+#else
+    #define POOL_CYCLES()           0
+#endif
+
+STATIC_ASSERT((POOL_CLASS_0 > 0) && (POOL_CLASS_7 <= 1024));        // class table spans 1 to 1024 bytes
+STATIC_ASSERT(!((POOL_CLASS_0 | POOL_CLASS_1 | POOL_CLASS_2 | POOL_CLASS_3 | POOL_CLASS_4 | POOL_CLASS_5 | POOL_CLASS_6 | POOL_CLASS_7) & 3));
+STATIC_ASSERT((POOL_CLASS_0 < POOL_CLASS_1) && (POOL_CLASS_1 < POOL_CLASS_2) && (POOL_CLASS_2 < POOL_CLASS_3) && (POOL_CLASS_3 < POOL_CLASS_4) &&
+              (POOL_CLASS_4 < POOL_CLASS_5) && (POOL_CLASS_5 < POOL_CLASS_6) && (POOL_CLASS_6 < POOL_CLASS_7));
+
+static const uint16_t pool_class[POOL_PARTITIONS] = {
+    POOL_CLASS_0, POOL_CLASS_1, POOL_CLASS_2, POOL_CLASS_3, POOL_CLASS_4, POOL_CLASS_5, POOL_CLASS_6, POOL_CLASS_7
+};
 
+/* ceil(2^32 / class), offset * reciprocal >> 32 is offset / class for offsets in a partition */
+#define POOL_RECIP(c)   ((uint32_t) ((0x100000000ULL + (c) - 1) / (c)))
 
-NEW_FIFO(g_pool_history, 2 * POOL_HISTORY_DEPTH);   // 2 bytes per history entry
-static pool_stats_t    g_pool_stat[POOL_PARTITIONS];
-static pool_profile_t  g_pool_profile;
-static char            g_pool[POOL_SIZE];           // master allocation of pool storage
+static const uint32_t pool_class_recip[POOL_PARTITIONS] = {
+    POOL_RECIP(POOL_CLASS_0), POOL_RECIP(POOL_CLASS_1), POOL_RECIP(POOL_CLASS_2), POOL_RECIP(POOL_CLASS_3),
+    POOL_RECIP(POOL_CLASS_4), POOL_RECIP(POOL_CLASS_5), POOL_RECIP(POOL_CLASS_6), POOL_RECIP(POOL_CLASS_7)
+};
+
+/* Best fit class of sizes 4i+1 .. 4i+4 is the number of classes smaller than 4i+4 */
+#define POOL_FIT(i)     ((POOL_CLASS_0 < (4 * ((i) + 1))) + (POOL_CLASS_1 < (4 * ((i) + 1))) + (POOL_CLASS_2 < (4 * ((i) + 1))) + \
+                         (POOL_CLASS_3 < (4 * ((i) + 1))) + (POOL_CLASS_4 < (4 * ((i) + 1))) + (POOL_CLASS_5 < (4 * ((i) + 1))) + \
+                         (POOL_CLASS_6 < (4 * ((i) + 1))))
+#define POOL_FIT4(i)    POOL_FIT(i),       POOL_FIT((i) + 1),   POOL_FIT((i) + 2),   POOL_FIT((i) + 3)
+#define POOL_FIT16(i)   POOL_FIT4(i),      POOL_FIT4((i) + 4),  POOL_FIT4((i) + 8),  POOL_FIT4((i) + 12)
+#define POOL_FIT64(i)   POOL_FIT16(i),     POOL_FIT16((i) + 16), POOL_FIT16((i) + 32), POOL_FIT16((i) + 48)
+
+static const uint8_t pool_class_fit[1024 / 4] = {
+    POOL_FIT64(0), POOL_FIT64(64), POOL_FIT64(128), POOL_FIT64(192)
+};
 
-NEW_BIT_VECTOR(g_blks_allocated_bv, POOL_BLOCKS);   // 1 if block allocated, 0 if free
-NEW_BIT_VECTOR(g_pool_bv, POOL_BLOCKS);             // scratch bit vector
+
+NEW_POOL(g_pool, POOL_PARTITION_SPEC);    // default pool for poolMalloc / poolFree
 
 
 /// \return the size of the partition referenced by index. Return zero if index is invalid.
-static size_t poolPartitionAtIndex(const size_t index) {
-    if (index > POOL_PARTITIONS) { return (0); }
-    else                         { return (1 << (index + 3)); }
+static size_t poolPartitionAtIndex(const int index) {
+    if ((index < 0) || (index >= POOL_PARTITIONS)) { return (0); }
+    else                                           { return (pool_class[index]); }
 }
 
-/// \return the smallest partition that will contain size. Return zero if no partition can contain size.
-static size_t poolBestFitPartition(const size_t size) {
-    for (int p=0; p<POOL_PARTITIONS; ++p) {             // from 8 partition to 1024
-        if (size <= poolPartitionAtIndex((size_t) p)) {
-            return (poolPartitionAtIndex((size_t) p));
-        }
-    }
-    return (0);
+/// \return the index of the smallest partition that will contain size. Return -1 if no partition can contain size.
+static int poolBestFitIndex(const size_t size) {
+    if (size == 0)                                        { return (0); }
+    if (size >  poolPartitionAtIndex(POOL_PARTITIONS-1))  { return (-1); }
+    return (pool_class_fit[(size - 1) >> 2]);
 }
 
-/// \return the array index of the given size partition. Return -1 if partition is invalid.
-static size_t poolPartitionIndex(const size_t size) {
-    for (int p=POOL_PARTITIONS-1; p>=0; --p) {          // from 1024 partition to 8
-        if (size == poolPartitionAtIndex((size_t) p)) {
-            return ((size_t) p);
-        }
+/// \return the mask of valid block bits in allocation word w of partition p.
+static uint32_t poolWordMask(const pool_obj_t pool, const int p, const int w) {
+    return (POOL_MASK(pool->geometry->blocks[p] - (32 * w)));
+}
+
+/// \return the index of the partition containing addr and set *offset to the byte offset of addr in the pool. Return -1 if addr is not in the pool.
+static int poolPartitionAtAddr(const pool_obj_t pool, const void * addr, uint32_t * offset) {
+    const pool_geometry_t * g = pool->geometry;
+    int       p;
+
+    if (((char *) addr < pool->mem) || ((char *) addr >= &pool->mem[g->size])) {
+        return (-1);                                        // not in the pool
+    }
+    *offset = (uint32_t) ((char *) addr - pool->mem);
+
+    for (p=POOL_PARTITIONS-1; p>=0; --p) {                  // from 1024 partition to 8
+        if (*offset < (g->offset[p] + (g->blocks[p] * pool_class[p]))) { break; }
     }
-    return (-1);
+    return (p);
 }
 
-/// \return the partition size of blk. Return zero if blk is invalid.
-static size_t poolBlkPartition(int blk) {
-    size_t  size = 0;
+/// \return true if addr is the start of a block, and set *p and *blk to its partition index and block number within the partition.
+static bool poolBlkAtAddr(const pool_obj_t pool, const void * addr, int * p, int * blk) {
+    uint32_t  offset;
 
-    if ((blk < 0) || (blk > POOL_BLOCKS)) {
-        return (0);
+    *p = poolPartitionAtAddr(pool, addr, &offset);
+    if (*p < 0) {
+        return (false);                                     // couldn't find address
     }
+    offset -= pool->geometry->offset[*p];
+    *blk = (int) (((uint64_t) offset * pool_class_recip[*p]) >> 32);
+    return (offset == ((uint32_t) *blk * pool_class[*p]));  // false if not the start of a block
+}
 
-    for (int p=POOL_PARTITIONS-1; p>=0; --p) {        // from 1024 partition to 8
-        if (!g_pool_blocks[p]) {                      // no blocks in this partition
-            continue;
-        }
-        if (blk > (g_pool_blocks[p] - 1)) {           // skip over this partition
-            blk -= g_pool_blocks[p];
-        }
-        else {
-            size = poolPartitionAtIndex((size_t) p);  // block in this partition, compute partition size
-            break;
-        }
+/// Atomically set bits in *addr. \return the previous value of *addr.
+static uint32_t poolSetBits(uint32_t volatile * const addr, uint32_t const bits) {
+    uint32_t  old;
+    do {
+        old = *addr;
+    } while (cpuCAS(addr, old, old | bits));
+    return (old);
+}
+
+/// Atomically clear bits in *addr. \return the previous value of *addr.
+static uint32_t poolClrBits(uint32_t volatile * const addr, uint32_t const bits) {
+    uint32_t  old;
+    do {
+        old = *addr;
+    } while (cpuCAS(addr, old, old & ~bits));
+    return (old);
+}
+
+/// Atomically add to the 16 bit counter at the low (hi == 0) or high half of *addr, wrapping within the half.
+static void poolCount(uint32_t volatile * const addr, const int hi, const int16_t n) {
+    uint32_t  old, shift = hi ? 16 : 0;
+    do {
+        old = *addr;
+    } while (cpuCAS(addr, old, (old & ~(0xffffUL << shift)) | ((((old >> shift) + n) & 0xffff) << shift)));
+}
+
+#ifdef PROFILE
+/// Atomically add n to cur_alloc of a partition and update the max_alloc high water mark.
+static void poolCountCurrent(pool_stats_t * const stat, const int16_t n) {
+    uint32_t volatile * const addr = (uint32_t volatile *) &stat->cur_alloc;    // cur_alloc:max_alloc are one word
+    uint32_t  old, cur;
+    do {
+        old = *addr;
+        cur = (old + n) & 0xffff;
+    } while (cpuCAS(addr, old, (MAX(cur, old >> 16) << 16) | cur));
+}
+#endif
+
+#if defined (PROFILE) || defined (POOL_TIMING)
+/// Atomically add n to *addr.
+static void poolAdd(uint32_t volatile * const addr, const uint32_t n) {
+    uint32_t  old;
+    do {
+        old = *addr;
+    } while (cpuCAS(addr, old, old + n));
+}
+#endif
+
+#if defined (POOL_TIMING) && !defined (POOL_CYCLES) && !defined (UNIT_TEST)
+  #if (__CORTEX_M == 0)
+/// SysTick cycles since start, modulo the period LOAD + 1. An operation is shorter than a period.
+static inline uint32_t poolSysTickElapsed(const uint32_t start) {
+    uint32_t  now = SysTick->VAL;
+    return ((now <= start) ? (start - now) : (start + SysTick->LOAD + 1 - now));
+}
+  #else
+/// Read DWT->CYCCNT, enabling the trace unit and the counter on the first read.
+static inline uint32_t poolCycleCounter(void) {
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
     }
-    return (size);
+    return (DWT->CYCCNT);
+}
+  #endif
+#endif
 
+/// Fold the cycles since start into the timing of an operation.
+static void poolTime(pool_timing_t * const t, const uint32_t start) {
+    #ifdef POOL_TIMING
+        uint32_t  cycles = POOL_ELAPSED(start);
+        uint32_t  old;
+
+        do {
+            old = t->min;                       // UINT32_MAX until the first call is timed
+        } while ((cycles < old) && cpuCAS(&t->min, old, cycles));
+        do {
+            old = t->max;
+        } while ((cycles > old) && cpuCAS(&t->max, old, cycles));
+        poolAdd(&t->total, cycles);
+        poolAdd(&t->cnt, 1);
+    #else
+        (void) t; (void) start;
+    #endif
 }
 
-/// \return the address of block blk. return NULL if the block is invalid.
-static void * poolBlkAddr(int blk) {
-    void *  addr = &g_pool;
+#ifdef PROFILE
+/// Record a pool operation in the history ring. The slot is claimed by advancing the count.
+static void poolHistory(pool_obj_t pool, const uint16_t entry) {
+    uint32_t  slot;
+    do {
+        slot = pool->history_cnt;
+    } while (cpuCAS(&pool->history_cnt, slot, slot + 1));
+    pool->history[slot % POOL_HISTORY_DEPTH] = entry;
+}
+#endif
 
-    if ((blk < 0) || (blk >= POOL_BLOCKS)) {
-        return (NULL);
+/*
+ * Mark allocation word w of partition p full in the summary, and the partition
+ * full if it was the last word with a free block. Each hint is re-checked after
+ * it is set and withdrawn if a block was freed concurrently.
+ */
+static void poolMarkFull(pool_obj_t pool, const int p, const int w) {
+    const pool_geometry_t * g = pool->geometry;
+    uint32_t volatile * leaf  = &pool->leaf[g->word[p] + w];
+
+    (void) poolSetBits(&pool->summary[p], 1UL << w);
+    if (~*leaf & poolWordMask(pool, p, w)) {                              // freed since it was seen full
+        (void) poolClrBits(&pool->summary[p], 1UL << w);
+        return;
     }
 
-    for (int p=POOL_PARTITIONS-1; p>=0; --p) {              // from 1024 partition to 8
-        if (!g_pool_blocks[p]) {                            // no blocks in this partition
+    if (!(~pool->summary[p] & POOL_MASK(POOL_WORDS(g->blocks[p])))) {     // every word is full
+        (void) poolSetBits(&pool->full, 1UL << p);
+        if (~pool->summary[p] & POOL_MASK(POOL_WORDS(g->blocks[p]))) {
+            (void) poolClrBits(&pool->full, 1UL << p);
+        }
+    }
+}
+
+/*
+ * Find the smallest partition in the partitions mask that has a free block,
+ * then the first allocation word in that partition with a free block, then
+ * the first free block in the word. Claim the block with a CAS on its
+ * allocation word, retrying the search if another context changed the word
+ * first. A word or partition found full on the way is marked full.
+ * \return the index of the partition allocated from and set *addr to the
+ * block, or return -1 if every partition in the mask is full.
+ */
+static int poolClaim(pool_obj_t pool, const uint32_t partitions, void ** addr) {
+    const pool_geometry_t * g = pool->geometry;
+    int       allocated, w, blk;
+    uint32_t  avail, old;
+    uint32_t volatile * leaf;
+
+    for (;;) {
+        avail = ~pool->full & partitions;
+        if (!avail) {
+            return (-1);                // every partition large enough is full
+        }
+        allocated = POOL_LSB(avail);
+
+        avail = ~pool->summary[allocated] & POOL_MASK(POOL_WORDS(g->blocks[allocated]));
+        if (!avail) {                   // stale partition hint
+            (void) poolSetBits(&pool->full, 1UL << allocated);
+            if (~pool->summary[allocated] & POOL_MASK(POOL_WORDS(g->blocks[allocated]))) {
+                (void) poolClrBits(&pool->full, 1UL << allocated);
+            }
             continue;
         }
-        if (blk > (g_pool_blocks[p] - 1)) {                 // increment address over this partition
-            addr += g_pool_blocks[p] * (1 << (p+3));
-            blk -= g_pool_blocks[p];
+        w    = POOL_LSB(avail);
+        leaf = &pool->leaf[g->word[allocated] + w];
+
+        old   = *leaf;
+        avail = ~old & poolWordMask(pool, allocated, w);
+        if (!avail) {                   // stale word hint
+            poolMarkFull(pool, allocated, w);
+            continue;
         }
-        else {
-            addr += blk * poolPartitionAtIndex((size_t) p); // block in this partition, point addr to it
-            break;
+        blk = POOL_LSB(avail);
+
+        if (!cpuCAS(leaf, old, old | (1UL << blk))) {                     // block claimed
+            if (!(avail & ~(1UL << blk))) {                               // it was the last free block in the word
+                poolMarkFull(pool, allocated, w);
+            }
+            *addr = &pool->mem[g->offset[allocated] + (((32 * w) + blk) * pool_class[allocated])];
+            return (allocated);
         }
     }
-    return (addr);
 }
 
-/// \return the block number corresponding to addr. Return -1 if addr is invalid.
-static int    poolBlkAtAddr(const void * addr) {
-    int     block = 0;
-    void *  cmp_addr = &g_pool;
+/*
+ * Clear the allocation bit of block blk of partition p, then the hints for
+ * its word and partition which can no longer be full.
+ * \return true if the block was allocated.
+ */
+static bool poolRelease(pool_obj_t pool, const int p, const int blk) {
+    uint32_t  bit = 1UL << (blk % 32);
+    bool      freed;
+
+    freed = !!(poolClrBits(&pool->leaf[pool->geometry->word[p] + (blk / 32)], bit) & bit);   // it is legal to free an already free block
+    (void) poolClrBits(&pool->summary[p], 1UL << (blk / 32));
+    (void) poolClrBits(&pool->full, 1UL << p);
+    return (freed);
+}
+
+/// \return the half (split == false) or split bit vector of blocks of the size of partition index p in a buddy pool.
+static struct bv_bit_vector_t poolBuddyVector(const pool_obj_t pool, const int p, const bool split) {
+    const pool_geometry_t * g = pool->geometry;
+    uint32_t  word = 0, half_n, split_n;
+
+    for (int r=0; ; ++r) {
+        half_n  = g->offset[r] >> POOL_PARTITION_SHIFT(r);                    // halves occur below partition r
+        split_n = r ? (g->offset[r-1] >> POOL_PARTITION_SHIFT(r)) : 0;        // split blocks also in partition r
+        if (r == p) { break; }
+        word += POOL_WORDS(half_n) + POOL_WORDS(split_n);
+    }
+    if (split) {
+        bv_bit_vector_t v = { split_n, &pool->buddy[word + POOL_WORDS(half_n)] };
+        return (v);
+    }
+    else {
+        bv_bit_vector_t v = { half_n, &pool->buddy[word] };
+        return (v);
+    }
+}
+
+/*
+ * Allocate a block of the size of partition p from a buddy pool. Take a free
+ * half or a native block of the smallest size that has one, then split it
+ * down to size p, marking each upper half free.
+ * \return p and set *addr to the block, or return -1 if no block is large enough.
+ */
+static int poolBuddyClaim(pool_obj_t pool, const int p, void ** addr) {
+    int       q, u = -1;
+    uint32_t  offset;
 
-    for (int p=POOL_PARTITIONS-1; p>=0; --p) {      // from 1024 partition to 8
-        for (int b=0; b<g_pool_blocks[p]; ++b) {
-            if (addr == cmp_addr) {
-                return (block);
+    LOCK;
+        for (q=p; q<POOL_PARTITIONS; ++q) {
+            bv_bit_vector_t half = poolBuddyVector(pool, q, false);
+            if (half.size && ((u = bvFF1(&half)) >= 0)) {                 // free half
+                (void) bvClr(&half, u);
+                *addr = &pool->mem[u << POOL_PARTITION_SHIFT(q)];
+                break;
             }
-            cmp_addr += 1 << (p+3);   // partition size
-            ++block;
+            if (poolClaim(pool, 1UL << q, addr) >= 0) { break; }          // native block
         }
+
+        if (q < POOL_PARTITIONS) {
+            offset = (uint32_t) ((char *) *addr - pool->mem);
+            for (; q>p; --q) {
+                bv_bit_vector_t split = poolBuddyVector(pool, q, true);
+                bv_bit_vector_t half  = poolBuddyVector(pool, q-1, false);
+                u = (int) (offset >> POOL_PARTITION_SHIFT(q));
+                (void) bvSet(&split, u);
+                (void) bvSet(&half, (2 * u) + 1);                         // upper half is free, split the lower half
+                poolCount((uint32_t *) &pool->stat[q].cnt_split, 0, 1);
+            }
+        }
+    END_LOCK;
+
+    return ((q == p) ? p : -1);
+}
+
+/// \return the size index of the block of a buddy pool at offset, found by descending through split blocks from its native partition.
+static int poolBuddyLevel(const pool_obj_t pool, const uint32_t offset, const int native) {
+    int       r = native;
+    int       u = (int) (offset >> POOL_PARTITION_SHIFT(r));
+
+    for (;;) {
+        bv_bit_vector_t split = poolBuddyVector(pool, r, true);
+        if ((r == 0) || !split.size || !bvTest(&split, u)) { break; }
+        --r;
+        u = (int) (offset >> POOL_PARTITION_SHIFT(r));
     }
-    return (-1);    // couldn't find address
+    return (r);
 }
 
-void * poolMalloc(size_t size) {
-    size_t  best_fit_partition, allocated_partition;
-    int     block;
-    void *  addr;
+/*
+ * Free a block of a buddy pool. Find the size of the block by descending
+ * through split blocks from the native partition of the address, then merge
+ * the block with its buddy for as long as the buddy is a free half.
+ * \return the index of the size freed, or -1 if addr was not an allocated block.
+ */
+static int poolBuddyRelease(pool_obj_t pool, const void * addr) {
+    int       native, r, u, freed = -1;
+    uint32_t  offset;
 
-    best_fit_partition = poolBestFitPartition(size);
+    native = poolPartitionAtAddr(pool, addr, &offset);
+    if (native < 0) {
+        return (-1);                                                      // not in the pool
+    }
 
-    do {
-        // put partition mask into bitvector, OR with allocated blocks, invert sense of allocation bitvector to allow FF1
-        g_pool_bv.array[0] = (uint32_t) g_partition_mask[poolPartitionIndex(best_fit_partition)];
-        g_pool_bv.array[1] = (uint32_t) (g_partition_mask[poolPartitionIndex(best_fit_partition)] >> 32);
+    LOCK;
+        r = poolBuddyLevel(pool, offset, native);
+        u = (int) (offset >> POOL_PARTITION_SHIFT(r));
 
-        bvOR(&g_pool_bv, &g_pool_bv, &g_blks_allocated_bv);   // mask partitions that are smaller than size requested
-        bvNOT(&g_pool_bv, &g_pool_bv);  // invert so that 1 = free
+        if (!(offset & ((1 << POOL_PARTITION_SHIFT(r)) - 1))) {           // start of a block
+            if (r == native) {
+                if (poolRelease(pool, native, (int) ((offset - pool->geometry->offset[native]) >> POOL_PARTITION_SHIFT(native)))) {
+                    freed = native;
+                }
+            }
+            else {
+                bv_bit_vector_t half = poolBuddyVector(pool, r, false);
+                if (!bvTest(&half, u)) {                                  // it is legal to free an already free block
+                    freed = r;
+                    while (r < native) {
+                        bv_bit_vector_t buddy = poolBuddyVector(pool, r, false);
+                        bv_bit_vector_t split = poolBuddyVector(pool, r+1, true);
+                        if (!bvTest(&buddy, u ^ 1)) {                     // buddy in use
+                            (void) bvSet(&buddy, u);
+                            break;
+                        }
+                        (void) bvClr(&buddy, u ^ 1);
+                        (void) bvClr(&split, u >> 1);
+                        poolCount((uint32_t *) &pool->stat[r+1].cnt_split, 1, 1);   // cnt_merge
+                        ++r;
+                        u >>= 1;
+                    }
+                    if (r == native) {                                    // merged back into a native block
+                        (void) poolRelease(pool, native, (int) ((offset - pool->geometry->offset[native]) >> POOL_PARTITION_SHIFT(native)));
+                    }
+                }
+            }
+        }
+    END_LOCK;
+
+    return (freed);
+}
+
+/*
+ * Split the allocated block at offset of size index p of a buddy pool down to
+ * size index q, keeping the lower half and freeing each upper half.
+ */
+static void poolBuddyShrink(pool_obj_t pool, const uint32_t offset, int p, const int q) {
+    int       u;
 
-        block = bvFF1(&g_pool_bv);
-        if (block == -1) {              // no blocks available to allocate
-           block = POOL_BLOCKS;         // flag with invalid block number
-           break;
+    LOCK;
+        for (; p>q; --p) {
+            bv_bit_vector_t split = poolBuddyVector(pool, p, true);
+            bv_bit_vector_t half  = poolBuddyVector(pool, p-1, false);
+            u = (int) (offset >> POOL_PARTITION_SHIFT(p));
+            (void) bvSet(&split, u);
+            (void) bvSet(&half, (2 * u) + 1);
+            poolCount((uint32_t *) &pool->stat[p].cnt_split, 0, 1);
         }
+    END_LOCK;
+}
 
-    } while (bvSet(&g_blks_allocated_bv, block)); // potential block found, try to atomically allocate it
+/// \return the size index of the allocated block at addr, or -1 if addr is not an allocated block of the pool.
+static int poolAllocatedIndex(const pool_obj_t pool, const void * addr) {
+    uint32_t  offset;
+    int       native, p, blk;
 
-    addr = poolBlkAddr(block);                    // invalid block will return NULL
+    if (pool->buddy) {                  // the splits above an allocated block do not change until it is freed
+        if ((native = poolPartitionAtAddr(pool, addr, &offset)) < 0) {
+            return (-1);
+        }
+        p = poolBuddyLevel(pool, offset, native);
+        if (offset & ((1 << POOL_PARTITION_SHIFT(p)) - 1)) {
+            return (-1);                // not the start of a block
+        }
+        if (p < native) {
+            bv_bit_vector_t half = poolBuddyVector(pool, p, false);
+            return (bvTest(&half, (int) (offset >> POOL_PARTITION_SHIFT(p))) ? -1 : p);
+        }
+        blk = (int) ((offset - pool->geometry->offset[p]) >> POOL_PARTITION_SHIFT(p));
+    }
+    else if (!poolBlkAtAddr(pool, addr, &p, &blk)) {
+        return (-1);
+    }
+    return ((pool->leaf[pool->geometry->word[p] + (blk / 32)] & (1UL << (blk % 32))) ? p : -1);
+}
 
+/// Record the allocation of a block of size index allocated (-1 if none) for a request of size bytes with best fit index best_fit.
+static void poolRecordMalloc(pool_obj_t pool, const size_t size, const int best_fit, const int allocated) {
     #ifdef PROFILE
-        if (addr) {
-            allocated_partition = poolBlkPartition(block);                          // size of allocated block (may be larger than optimal)
-            fifoPush16(g_pool_history, (uint16_t) (POOL_HISTORY_ALLOC | allocated_partition));  // record that a block of size allocated_partition was allocated
-            if (best_fit_partition != allocated_partition) {
-                g_pool_stat[poolPartitionIndex(best_fit_partition)].cnt_fail += 1;  // failed to allocate optimal sized partition
+        if (allocated >= 0) {
+            poolHistory(pool, (uint16_t) (POOL_HISTORY_ALLOC | poolPartitionAtIndex(allocated)));   // record that a block of size allocated_partition was allocated
+            if (best_fit != allocated) {
+                poolCount((uint32_t *) &pool->stat[best_fit].cnt_alloc, 1, 1);  // cnt_fail, failed to allocate optimal sized partition
             }
-            g_pool_stat[poolPartitionIndex(allocated_partition)].cnt_alloc += 1;    // record number of times partition was allocated
-            g_pool_stat[poolPartitionIndex(allocated_partition)].cur_alloc += 1;    // track blocks currently allocated
-
-            // set high water mark
-            g_pool_stat[poolPartitionIndex(allocated_partition)].max_alloc =  MAX(g_pool_stat[poolPartitionIndex(allocated_partition)].max_alloc,
-                                                                                  g_pool_stat[poolPartitionIndex(allocated_partition)].cur_alloc);
+            poolCount((uint32_t *) &pool->stat[allocated].cnt_alloc, 0, 1);     // record number of times partition was allocated
+            poolCountCurrent(&pool->stat[allocated], 1);                        // track blocks currently allocated and high water mark
+            poolAdd(&pool->stat[allocated].waste, poolPartitionAtIndex(allocated) - size);   // internal fragmentation
+            poolAdd(&pool->stat[allocated].requested, size);
         }
         else {
-            g_pool_stat[poolPartitionIndex(best_fit_partition)].cnt_fail += 1;      // failed to allocate optimal (or any!) sized partition
+            poolCount((uint32_t *) &pool->stat[best_fit].cnt_alloc, 1, 1);      // cnt_fail, failed to allocate optimal (or any!) sized partition
         }
+    #else
+        (void) pool; (void) size; (void) best_fit; (void) allocated;
     #endif
+}
 
-    return (addr);
+/// Record the free of a block of size index allocated.
+static void poolRecordFree(pool_obj_t pool, const int allocated) {
+    #ifdef PROFILE
+        poolHistory(pool, (uint16_t) (POOL_HISTORY_FREE | poolPartitionAtIndex(allocated)));    // record that a block of size allocated_partition was freed
+        poolCountCurrent(&pool->stat[allocated], -1);                           // track blocks currently allocated
+    #else
+        (void) pool; (void) allocated;
+    #endif
 }
 
-void poolFree(void * addr) {
-    size_t   allocated_partition;
-    int      block;
+void * poolMallocFrom(pool_obj_t pool, size_t size) {
+    uint32_t  start = POOL_CYCLES();
+    int       best_fit, allocated;
+    void *    addr = NULL;
+
+    REQUIRE (pool != NULL);
+
+    best_fit = poolBestFitIndex(size);
+    if (best_fit < 0) {
+        poolTime(&pool->timing[POOL_TIMING_MALLOC], start);
+        return (NULL);                  // larger than the largest partition
+    }
+
+    if (pool->buddy) { allocated = poolBuddyClaim(pool, best_fit, &addr); }
+    else             { allocated = poolClaim(pool, (~0UL << best_fit) & POOL_MASK(POOL_PARTITIONS), &addr); }
 
-    block = poolBlkAtAddr(addr);
-    if ((block != -1) && bvClr(&g_blks_allocated_bv, block)) {    // free block if valid
-        allocated_partition = poolBlkPartition(block);            // update stats only if freed block was allocated (it is legal to free an already free block)
-        fifoPush16(g_pool_history, (uint16_t) (POOL_HISTORY_FREE | allocated_partition));  // record that a block of size allocated_partition was freed
-        g_pool_stat[poolPartitionIndex(allocated_partition)].cur_alloc -= 1;                        // track blocks currently allocated
+    poolRecordMalloc(pool, size, best_fit, allocated);
+
+    poolTime(&pool->timing[POOL_TIMING_MALLOC], start);
+    return ((allocated >= 0) ? addr : NULL);
+}
+
+void poolFreeTo(pool_obj_t pool, void * addr) {
+    uint32_t  start = POOL_CYCLES();
+    int       allocated, blk;
+
+    REQUIRE (pool != NULL);
+
+    if (pool->buddy) {
+        allocated = poolBuddyRelease(pool, addr);
+    }
+    else if (!poolBlkAtAddr(pool, addr, &allocated, &blk) || !poolRelease(pool, allocated, blk)) {
+        allocated = -1;                                           // not an allocated block in the pool
+    }
+
+    if (allocated >= 0) {                                         // update stats only if freed block was allocated
+        poolRecordFree(pool, allocated);
+    }
+    poolTime(&pool->timing[POOL_TIMING_FREE], start);
+}
+
+/*
+ * A block that still fits and is not larger than its best fit is kept. A
+ * block that is larger than its best fit is moved to a smaller block if one
+ * is free, or in a buddy pool split in place, to release the larger block.
+ * A block that is too small is moved. A block that cannot be moved is kept
+ * unchanged and NULL is returned.
+ */
+void * poolReallocFrom(pool_obj_t pool, void * addr, size_t size) {
+    int       p, best_fit, allocated;
+    void *    new_addr = NULL;
+
+    REQUIRE (pool != NULL);
+
+    if (addr == NULL) {
+        return (poolMallocFrom(pool, size));
+    }
+    if ((p = poolAllocatedIndex(pool, addr)) < 0) {
+        return (NULL);                                            // not an allocated block in the pool
+    }
+    if (size == 0) {
+        poolFreeTo(pool, addr);
+        return (NULL);
+    }
+    if ((best_fit = poolBestFitIndex(size)) < 0) {
+        return (NULL);                                            // larger than the largest partition
+    }
+
+    if (best_fit == p) {
+        return (addr);                                            // still fits, same size
+    }
+
+    if (best_fit < p) {                                           // shrink
+        if (pool->buddy) {
+            poolBuddyShrink(pool, (uint32_t) ((char *) addr - pool->mem), p, best_fit);
+            poolRecordFree(pool, p);
+            poolRecordMalloc(pool, size, best_fit, best_fit);     // the first half is a new block of best_fit
+            return (addr);
+        }
+        allocated = poolClaim(pool, POOL_MASK(p) & ~POOL_MASK(best_fit), &new_addr);
+        if (allocated < 0) {
+            return (addr);                                        // no smaller block free, keep the block
+        }
+        poolRecordMalloc(pool, size, best_fit, allocated);
+    }
+    else if (!(new_addr = poolMallocFrom(pool, size))) {         // grow
+        return (NULL);
     }
+
+    (void) memcpy(new_addr, addr, MIN(size, poolPartitionAtIndex(p)));
+    poolFreeTo(pool, addr);
+    return (new_addr);
+}
+
+pool_profile_t * poolProfileOf(pool_obj_t pool) {
+    REQUIRE (pool != NULL);
+
+    pool->profile.pool_stat = pool->stat;
+    pool->profile.pool_history = pool->history;
+    pool->profile.pool_history_cnt = &pool->history_cnt;
+    pool->profile.pool_state = pool->leaf;
+    pool->profile.pool_timing = pool->timing;
+    return (&pool->profile);
+}
+
+void * poolMalloc(size_t size) {
+    return (poolMallocFrom(g_pool, size));
+}
+
+void poolFree(void * addr) {
+    poolFreeTo(g_pool, addr);
+}
+
+void * poolRealloc(void * addr, size_t size) {
+    return (poolReallocFrom(g_pool, addr, size));
 }
 
 pool_profile_t * poolProfile(void) {
-    g_pool_profile.pool_stat = g_pool_stat;
-    g_pool_profile.pool_history = g_pool_history;
-    g_pool_profile.pool_state = (uint64_t *) g_blks_allocated_bv.array;
-    return (&g_pool_profile);
+    return (poolProfileOf(g_pool));
+}
+
+/*
+ * The history is output from a snapshot of the count. Entries overwritten
+ * while the dump is in progress are output with their new value.
+ */
+void poolDumpOf(pool_obj_t pool, pool_print_t print) {
+    const pool_geometry_t * g;
+    pool_stats_t  stat;
+    uint32_t      cnt = 0;
+
+    REQUIRE (pool != NULL);
+    REQUIRE (print != NULL);
+    g = pool->geometry;
+
+    #ifdef PROFILE
+        cnt = pool->history_cnt;
+    #endif
+    print("POOL %u %u %u\r", (unsigned) g->size, (unsigned) cnt, (unsigned) POOL_HISTORY_DEPTH);
+
+    for (int p=0; p<POOL_PARTITIONS; ++p) {
+        stat = pool->stat[p];
+        print("CLASS %u %u %u %u %u %u %u %u\r", (unsigned) poolPartitionAtIndex(p), (unsigned) g->blocks[p],
+              (unsigned) stat.cur_alloc, (unsigned) stat.max_alloc, (unsigned) stat.cnt_alloc,
+              (unsigned) stat.cnt_fail, (unsigned) stat.waste, (unsigned) stat.requested);
+    }
+
+    #ifdef POOL_TIMING
+        for (int op=POOL_TIMING_MALLOC; op<=POOL_TIMING_FREE; ++op) {
+            pool_timing_t t = pool->timing[op];
+            print("TIME %s %u %u %u %u\r", (op == POOL_TIMING_MALLOC) ? "MALLOC" : "FREE", (unsigned) (t.cnt ? t.min : 0),
+                  (unsigned) t.max, (unsigned) (t.cnt ? (t.total / t.cnt) : 0), (unsigned) t.cnt);
+        }
+    #endif
+
+    #ifdef PROFILE
+        uint32_t  i = (cnt > POOL_HISTORY_DEPTH) ? (cnt - POOL_HISTORY_DEPTH) : 0;     // oldest entry still in the ring
+        uint32_t  n;
+        while (i < cnt) {
+            char      line[16 * 5 + 1], *c = line;
+            uint16_t  entry;
+
+            for (n=MIN(cnt - i, 16); n; --n) {
+                entry = pool->history[i++ % POOL_HISTORY_DEPTH];
+                *c++  = ' ';
+                for (int shift=12; shift>=0; shift-=4) {
+                    *c++ = "0123456789abcdef"[(entry >> shift) & 0xf];
+                }
+            }
+            *c = '\0';
+            print("HIST%s\r", line);
+        }
+    #endif
+
+    print("END\r");
+}
+
+void poolDump(pool_print_t print) {
+    poolDumpOf(g_pool, print);
 }
 
 /*****************************************************************************
 
    DL: A type-independent fixed sized ring buffer delay line. Thread safe.
 
-        The number of delay line entries is limited to 64K.
+        The number of delay line entries is limited to 64K (see MEMORY_INDEX_32).
         The delay line contents are type independent - parameters must be cast to the proper type.
         The delay line is allocated at compile-time and cannot be resized or dynamically created.
         Each delay line is instantiated as an opaque object of type (void *).
@@ -272,26 +817,21 @@ pool_profile_t * poolProfile(void) {
 
    Revision History:
     02/20/15  Initial release
+    10/16/26  Added mirrored delay line and dlWindow, dlUpdate without modulo or byte loop
+    10/16/26  Added dlUpdateN
+    10/16/26  dl_obj_t moved to memory.h, element 8 byte aligned to match the macros
 
  *****************************************************************************/
 
-typedef struct  {
-    const uint16_t  taps;
-    uint16_t        index;        // always points to tap zero
-    const size_t    type_size;
-    char            element[];
-} dl_obj_t;
-
-
 /*
  *  Add dl_element to the ring buffer. Discard the oldest element. The type
  *  of dl_element is unknown, so treat it as an array of type_size
- *  char characters. index always points to tap zero.
+ *  char characters. index always points to tap zero. A mirrored delay line
+ *  also stores the element at index + taps.
  *
  */
 void dlUpdate(void * dl_obj, void * dl_element) {
     dl_obj_t * dl  = (dl_obj_t *) dl_obj;
-    char * element = (char *) dl_element;
     int offset;
 
     LOCK;
@@ -299,11 +839,12 @@ void dlUpdate(void * dl_obj, void * dl_element) {
     REQUIRE (dl->taps > 0);
     REQUIRE (dl->index < dl->taps);
 
-    dl->index = ((dl->index - 1) + dl->taps) % dl->taps;   // point to new tap zero
+    dl->index = (dl->index ? dl->index : dl->taps) - 1;   // point to new tap zero
     offset = dl->index * dl->type_size;
 
-    for (int i=0; i<dl->type_size; ++i) {
-        dl->element[i + offset] = element[i];
+    memcpy(&dl->element[offset], dl_element, dl->type_size);
+    if (dl->mirror) {
+        memcpy(&dl->element[offset + (dl->mirror * dl->type_size)], dl_element, dl->type_size);
     }
 
     ENSURE (dl->index < dl->taps);
@@ -311,23 +852,86 @@ void dlUpdate(void * dl_obj, void * dl_element) {
     END_LOCK;
 }
 
+/*
+ *  Store count elements of src at dst in reverse order, src[0] is stored
+ *  last. Element sizes of 2 and 4 are copied with constant size memcpy.
+ */
+static void dlStoreReversed(char * dst, const char * src, mem_index_t count, size_t type_size) {
+    dst += count * type_size;
+    switch (type_size) {
+        case 2:  while (count--) { dst -= 2; memcpy(dst, src, 2); src += 2; }                         break;
+        case 4:  while (count--) { dst -= 4; memcpy(dst, src, 4); src += 4; }                         break;
+        default: while (count--) { dst -= type_size; memcpy(dst, src, type_size); src += type_size; } break;
+    }
+}
+
+/*
+ *  Add n elements to the ring buffer, the same as n calls of dlUpdate in
+ *  order, so dl_elements[n-1] becomes tap zero. Elements older than the
+ *  last taps of the block would be discarded and are not copied.
+ *
+ *  Tap zero is at the lowest index, so the block is stored in reverse in
+ *  at most two segments: from index down to zero, then from the top of
+ *  the ring buffer down. The mirror is the same segments in order and is
+ *  copied with memcpy. The index is updated once, without a modulo. As in
+ *  dlUpdate the copy is inside the lock, whose length is proportional to
+ *  MIN(n, taps).
+ */
+void dlUpdateN(void * dl_obj, const void * dl_elements, mem_index_t n) {
+    dl_obj_t *   dl  = (dl_obj_t *) dl_obj;
+    const char * src = (const char *) dl_elements;
+    mem_index_t  low, high;
+
+    if (n > dl->taps) {
+        src += (n - dl->taps) * dl->type_size;
+        n    = dl->taps;
+    }
+
+    LOCK;
+
+    REQUIRE (dl->taps > 0);
+    REQUIRE (dl->index < dl->taps);
+
+    low  = MIN(n, dl->index);     // elements stored at index - 1 down to index - low
+    high = n - low;               // elements stored at taps - 1 down to taps - high
+
+    dlStoreReversed(&dl->element[(dl->index - low) * dl->type_size], src, low, dl->type_size);
+    dlStoreReversed(&dl->element[(dl->taps - high) * dl->type_size], src + (low * dl->type_size), high, dl->type_size);
+    if (dl->mirror) {
+        memcpy(&dl->element[(dl->index - low + dl->mirror) * dl->type_size],
+               &dl->element[(dl->index - low) * dl->type_size], low * dl->type_size);
+        memcpy(&dl->element[(dl->taps - high + dl->mirror) * dl->type_size],
+               &dl->element[(dl->taps - high) * dl->type_size], high * dl->type_size);
+    }
+
+    dl->index = high ? (dl->taps - high) : (dl->index - low);   // point to new tap zero
+
+    ENSURE (dl->index < dl->taps);
+
+    END_LOCK;
+}
+
 /*
  * Allow python style indexing where [-1] is the last entry of the array.
  * Also allow tap to be > number of taps in delay line.
  */
-void * dlGetTap(void * dl_obj, int16_t tap) {
+void * dlGetTap(void * dl_obj, mem_sindex_t tap) {
     dl_obj_t * dl = (dl_obj_t *) dl_obj;
-    int offset;
+    int32_t    taps = (int32_t) dl->taps;   // wider than a 16 bit index, a line may not fill the 32 bit range
+    int32_t    t = tap;
+    uint32_t   offset;
 
     LOCK;
 
     REQUIRE (dl->taps > 0);
     REQUIRE (dl->index < dl->taps);
 
-    tap %= dl->taps;      // abs(tap) < dl->taps
-    if (tap < 0) { tap += dl->taps; }
+    t %= taps;                          // abs(t) < taps
+    if (t < 0) { t += taps; }
 
-    offset = ((dl->index + tap) % dl->taps) * dl->type_size;
+    offset = dl->index + (uint32_t) t;  // t >= 0
+    if (!dl->mirror && (offset >= dl->taps)) { offset -= dl->taps; }   // a mirrored line doesn't wrap
+    offset *= dl->type_size;
 
     END_LOCK;
 
@@ -339,7 +943,7 @@ void * dlGetTap(void * dl_obj, int16_t tap) {
  * to 'freeze' the state of the ring buffer without concern about the
  * indices moving from a call to dlUpdate.
  */
-uint16_t dlGetIndex(void * dl_obj) {
+mem_index_t dlGetIndex(void * dl_obj) {
     dl_obj_t * dl = (dl_obj_t *) dl_obj;
 
     return (dl->index);
@@ -360,6 +964,11 @@ void * dlAsArray(void * dl_obj) {
     REQUIRE (dl->taps > 0);
     REQUIRE (dl->index < dl->taps);
 
+    if (dl->mirror) {                                         // already contiguous from tap zero
+        END_LOCK;
+        return (dlWindow(dl_obj));
+    }
+
     len    = dl->taps * dl->type_size;                        // size of element array
     offset = dl->index * dl->type_size;                       // element[offset] is tap zero element
 
@@ -386,13 +995,25 @@ void * dlAsArray(void * dl_obj) {
 }
 
 
-uint16_t dlTaps(void * dl_obj) {
+mem_index_t dlTaps(void * dl_obj) {
     dl_obj_t * dl  = (dl_obj_t *) dl_obj;
 
     return (dl->taps);
 }
 
 
+/*
+ * Tap zero of a mirrored delay line is followed by the remaining taps in
+ * order, the ones past the end of the ring buffer are read from the mirror.
+ */
+void * dlWindow(void * dl_obj) {
+    dl_obj_t * dl  = (dl_obj_t *) dl_obj;
+
+    REQUIRE (dl->mirror);
+    return ((void *) &dl->element[dl->index * dl->type_size]);
+}
+
+
 
 /*****************************************************************************
 
@@ -409,11 +1030,13 @@ uint16_t dlTaps(void * dl_obj) {
    'poolname' is the _obuf_obj_t object name passed to NEW_OBUF.
 
    The size of the instantiated pool is the requested size rounded up to
-   a multiple of 8 bytes plus 12 bytes of overhead.
+   a multiple of 8 bytes plus 16 bytes of overhead.
 
    Blocks should be freed in the same order that they are malloc'd. Blocks
    may be freed out of order, blocks are not returned to the pool until the
-   oldest allocated block is freed.
+   oldest allocated block is freed. obufMalloc() and in-order obufFree()
+   execute in constant time. An out-of-order obufFree() searches the
+   allocated blocks to validate the pointer.
 
    If obufFree() is called with a pointer that does not lie
    within the ring buffer the call will be ignored and return with no error.
@@ -443,25 +1066,37 @@ uint16_t dlTaps(void * dl_obj) {
     07/11/14  Removed restriction that blocks be freed in the order allocated, added obufMemAvail()
     07/11/14  Added obufMemAvail for diagnostics
     07/12/14  Added max_free, max_frag for diagnostics
+    10/16/26  Track newest block and flag out-of-order frees, constant time malloc and in-order free
+    10/16/26  obufReserve / obufCommit
+    10/16/26  Single-producer/single-consumer mode without critical sections
 
  *****************************************************************************/
 
 
 /*
  * Allocated blocks are maintained with a linked list, with oldest pointing
- * to the least-recent block allocated from the pool. The next pointer for
- * the last block allocated will point to the next available free location.
+ * to the least-recent block allocated from the pool and newest pointing to
+ * the most-recent. The next pointer for the last block allocated will point
+ * to the next available free location.
  *
  * The data block links are allocated in the buffer, immediately in front of
  * the data area that is allocated to the caller. Only the next pointer is
- * additive to the data block.
- *
+ * additive to the data block. Blocks are 4-byte aligned so bit 0 of the next
+ * pointer is free to flag a block that has been freed out of order.
+ */
+#define OBUF_FREED              ((uintptr_t) 1)
+#define OBUF_NEXT(blk)          ((p_obuf_dblk_t) ((uintptr_t) (blk)->next & ~OBUF_FREED))
+#define OBUF_IS_FREED(blk)      ((uintptr_t) (blk)->next & OBUF_FREED)
+#define OBUF_SET_NEXT(blk, nxt) ((blk)->next = (p_obuf_dblk_t) ((uintptr_t) (nxt) | OBUF_IS_FREED(blk)))
+
+/*
  * Return NULL if a block of memory cannot be allocated from the pool.
  */
 void * obufMalloc(obuf_obj_t pool, uint32_t size) {
     char *        bot          = pool->buf;
     char *        top          = bot + pool->size;
     p_obuf_dblk_t newest;
+    p_obuf_dblk_t next;
     p_obuf_dblk_t allocated;
     bool          f_allocate   = FALSE;  // true if sufficient free memory is available
     int32_t       total_size;            // requested size + rounding & overhead
@@ -475,38 +1110,36 @@ void * obufMalloc(obuf_obj_t pool, uint32_t size) {
     total_size = size + sizeof(p_obuf_dblk_t);  // add space for the next pointer
 
     LOCK;
-    /* find most-recently allocated block */
-    newest = pool->oldest;
-    for (int i=1; i<pool->n_blks; ++i) {  // newest is also oldest if only one block
-        newest = newest->next;
-    }
+    empty  = (pool->n_blks == 0);
+    newest = empty ? pool->oldest : pool->newest;   // oldest->next is the bottom of the pool if empty
+    next   = OBUF_NEXT(newest);
 
-    space_above   = (top - ((char *) newest->next));  // free memory in the interval next free to top (assuming next hasn't wrapped to bottom)
+    space_above   = (top - ((char *) next));          // free memory in the interval next free to top (assuming next hasn't wrapped to bottom)
     space_below   = (((char *) pool->oldest) - bot);  // free memory in the interval bot to oldest (assuming next hasn't wrapped, but will)
-    space_between = (((char *) pool->oldest) - ((char *) newest->next)); // free memory in the middle interval if next has wrapped to the bottom of the pool
+    space_between = (((char *) pool->oldest) - ((char *) next)); // free memory in the middle interval if next has wrapped to the bottom of the pool
 
     f_sabv  = space_above >= total_size;   // sufficient free memory above
     f_sblw  = space_below >= total_size;   // sufficient free memory below
     f_sbtwn = space_between >= total_size; // sufficient free memory below in the middle
-    empty   = (pool->n_blks == 0);
 
-    if (empty || (pool->oldest < newest->next)) {   // next hasn't wrapped so free memory is at the ends of the pool, oldest == next if empty or possibly if full
+    if (empty || (pool->oldest < next)) {           // next hasn't wrapped so free memory is at the ends of the pool, oldest == next if empty or possibly if full
         if (f_sabv | f_sblw) {                      // free memory is sufficient to meet request
             f_allocate = TRUE;
             if (!f_sabv) {                          // wrap to bottom of pool
-                newest->next = (p_obuf_dblk_t) bot;
+                OBUF_SET_NEXT(newest, bot);
             }
         }
-        pool->min_free = MIN(pool->min_free, space_above + space_below - total_size);
+        pool->min_free = MIN(pool->min_free, (mem_index_t) MAX(space_above + space_below - total_size, 0));
     }
     else if (f_sbtwn) {                             // free memory is in the middle of the pool
         f_allocate = TRUE;
-        pool->min_free = MIN(pool->min_free, space_between - total_size);
+        pool->min_free = MIN(pool->min_free, (mem_index_t) (space_between - total_size));
     }
 
     if (f_allocate) {
-        allocated = newest->next;
+        allocated = OBUF_NEXT(newest);
         ++(pool->n_blks);
+        pool->newest = allocated;
         allocated->next = (p_obuf_dblk_t) (((char *) allocated) + total_size);
         ENSURE (allocated->next <= (p_obuf_dblk_t) top);  // error if it goes past the top
         if (allocated->next > (p_obuf_dblk_t) (top - sizeof(struct obuf_dblk_t))) {  // wrap if no room for at least a min-size data block at top
@@ -523,8 +1156,10 @@ void * obufMalloc(obuf_obj_t pool, uint32_t size) {
 
 /*
  * Memory blocks are not returned to the pool until the least-recently allocated
- * block is freed. It is allowed to Free a pointer that does not point to
- * somewhere in the pool.
+ * block is freed. Freeing the oldest block returns it, and any blocks after it
+ * that were freed out of order, to the pool. Freeing any other block searches
+ * the list to validate the pointer and flags the block as freed. It is allowed
+ * to Free a pointer that does not point to somewhere in the pool.
  */
 obuf_error_t  obufFree(obuf_obj_t pool, void * ptr) {
     char *        bot   = pool->buf;
@@ -533,29 +1168,29 @@ obuf_error_t  obufFree(obuf_obj_t pool, void * ptr) {
 
     REQUIRE (pool != NULL);
     if ((ptr < ((void *) top)) && (ptr >= ((void *) bot))) {
-        LOCK;   // points into pool, traverse linked list looking for ptr
-        p_obuf_dblk_t target_blk    = pool->oldest;
-        p_obuf_dblk_t ptr_to_target = (p_obuf_dblk_t) &(pool->oldest);
+        LOCK;   // points into pool
+        p_obuf_dblk_t target_blk = pool->oldest;
         int blk_cnt = pool->n_blks;
-        while (blk_cnt) {
-            if (ptr == (void *) target_blk->data) {     // valid ptr, free the memory
-                ptr_to_target->next = target_blk->next; // free the memory
-                --(pool->n_blks);
-                if (pool->n_blks == 0) {                // reset to bottom of pool if now empty
-                    pool->oldest       = (p_obuf_dblk_t) bot;
-                    pool->oldest->next = (p_obuf_dblk_t) bot;
-                }
 
-                break;
-            }
-            ptr_to_target = ptr_to_target->next;
-            target_blk = target_blk->next;
+        while (blk_cnt && (ptr != (void *) target_blk->data)) {  // oldest first, in order free does not loop
+            target_blk = OBUF_NEXT(target_blk);
             ENSURE(target_blk);
             --blk_cnt;
         }
 
-        if (blk_cnt == 0) {
-            rslt = OBUF_INVALID_POINTER;  // empty pool, invalid or messed-up pointer
+        if ((blk_cnt == 0) || OBUF_IS_FREED(target_blk)) {
+            rslt = OBUF_INVALID_POINTER;  // empty pool, already freed, invalid or messed-up pointer
+        }
+        else {
+            target_blk->next = (p_obuf_dblk_t) ((uintptr_t) target_blk->next | OBUF_FREED);
+            while (pool->n_blks && OBUF_IS_FREED(pool->oldest)) {   // return the oldest freed blocks to the pool
+                pool->oldest = OBUF_NEXT(pool->oldest);
+                --(pool->n_blks);
+            }
+            if (pool->n_blks == 0) {                // reset to bottom of pool if now empty
+                pool->oldest       = (p_obuf_dblk_t) bot;
+                pool->oldest->next = (p_obuf_dblk_t) bot;
+            }
         }
         END_LOCK;
     }
@@ -564,25 +1199,179 @@ obuf_error_t  obufFree(obuf_obj_t pool, void * ptr) {
 
 
 /*
- * Return the first n_ptrs data pointers of the pool linked list. The ptr_array
- * list must be sized to accept n_ptrs + 1. The ptr_array will be terminated
- * with a NULL entry after the last valid data pointer.
+ * A reserved block is an ordinary block of max bytes until it is committed.
+ */
+void * obufReserve(obuf_obj_t pool, uint32_t max) {
+    return (obufMalloc(pool, max));
+}
+
+
+/*
+ * Shrink the newest block to size bytes by moving its next pointer, which is
+ * the start of free memory, back to the end of the committed data. The
+ * wrap-to-bottom rule of obufMalloc is re-applied to the new end. The
+ * reservation of a block that wrapped includes the unused space up to top.
+ * A block that is no longer the newest keeps its reserved size.
+ */
+obuf_error_t  obufCommit(obuf_obj_t pool, void * ptr, uint32_t size) {
+    char *        bot   = pool->buf;
+    char *        top   = bot + pool->size;
+    obuf_error_t  rslt  = OBUF_INVALID_POINTER;
+    p_obuf_dblk_t blk, next;
+    char *        end;
+
+    REQUIRE (pool != NULL);
+    if ((ptr >= ((void *) top)) || (ptr < ((void *) bot))) {
+        return (OBUF_INVALID_POINTER);
+    }
+
+    size = (MAX(size, 1) + 3) & ~3;             // round up to a 4-byte boundary, at least a min-size data block
+
+    LOCK;
+    blk = pool->newest;
+    if (pool->n_blks && (ptr == (void *) blk->data) && !OBUF_IS_FREED(blk)) {
+        next = OBUF_NEXT(blk);
+        end  = ((char *) blk->data) + size;
+        if (end <= ((next == (p_obuf_dblk_t) bot) ? top : (char *) next)) {    // within the reserved block
+            if (end > (top - sizeof(struct obuf_dblk_t))) {                     // wrap if no room for at least a min-size data block at top
+                end = bot;
+            }
+            blk->next = (p_obuf_dblk_t) end;
+            rslt = OBUF_NOERR;
+        }
+    }
+    else {                                      // validate the pointer, the block keeps its reserved size
+        blk = pool->oldest;
+        for (mem_index_t i=0; i<pool->n_blks; ++i) {
+            if ((ptr == (void *) blk->data) && !OBUF_IS_FREED(blk)) {
+                rslt = OBUF_NOERR;
+                break;
+            }
+            blk = OBUF_NEXT(blk);
+        }
+    }
+    END_LOCK;
+    return (rslt);
+}
+
+
+/*
+ * SPSC mode. newest is the start of free memory (the producer's head) rather
+ * than the newest block and is written only by the producer. oldest is written
+ * only by the consumer. The pool is empty when they are equal, so one block of
+ * free memory always separates a full pool's head from oldest. When a block
+ * does not fit above head the remainder of the pool is marked with a freed
+ * block header that the consumer skips. Each side reads the other's pointer
+ * once, and barriers order block contents before the pointer that publishes
+ * (producer) or releases (consumer) them.
+ */
+#define OBUF_SHARED(ptr)  (*(p_obuf_dblk_t volatile *) &(ptr))
+
+void * obufSpscMalloc(obuf_obj_t pool, uint32_t size) {
+    char *        bot    = pool->buf;
+    char *        top    = bot + pool->size;
+    p_obuf_dblk_t head   = pool->newest;
+    p_obuf_dblk_t oldest = OBUF_SHARED(pool->oldest);
+    p_obuf_dblk_t allocated = NULL;
+    char *        next;
+    int32_t       total_size;
+    int           space_above, space_below;
+
+    if (size == 0) { return (NULL); }
+    REQUIRE (pool != NULL);
+
+    size = (size + 3) & ~3;                     // round up to a 4-byte boundary
+    total_size = size + sizeof(p_obuf_dblk_t);  // add space for the next pointer
+    CPU_DMB;                                    // oldest is read before its memory is reused
+
+    if (head >= oldest) {                       // free memory at the ends of the pool, or empty
+        space_above = top - ((char *) head);
+        space_below = ((char *) oldest) - bot;
+        next        = ((char *) head) + total_size;
+        if ((space_above >= total_size) && ((next <= (top - sizeof(struct obuf_dblk_t))) || (oldest != (p_obuf_dblk_t) bot))) {
+            allocated = head;                   // fits above without wrapping onto oldest
+        }
+        else if (space_below > total_size) {    // wrap, skip the rest of the pool
+            head->next = (p_obuf_dblk_t) ((uintptr_t) bot | OBUF_FREED);
+            allocated = (p_obuf_dblk_t) bot;
+        }
+        if (allocated) {
+            pool->min_free = MIN(pool->min_free, (mem_index_t) (space_above + space_below - total_size));
+        }
+    }
+    else if ((((char *) oldest) - ((char *) head)) > total_size) {  // free memory in the middle of the pool
+        allocated = head;
+        pool->min_free = MIN(pool->min_free, (((char *) oldest) - ((char *) head)) - total_size);
+    }
+
+    if (allocated) {
+        next = ((char *) allocated) + total_size;
+        if (next > (top - sizeof(struct obuf_dblk_t))) {  // wrap if no room for at least a min-size data block at top
+            next = bot;
+        }
+        allocated->next = (p_obuf_dblk_t) next;
+        CPU_DMB;                                // block header is written before it is published
+        OBUF_SHARED(pool->newest) = (p_obuf_dblk_t) next;
+    }
+    else {
+        ++pool->n_failed;
+    }
+    return (allocated ? (void *) &(allocated->data) : NULL);
+}
+
+
+void * obufSpscOldest(obuf_obj_t pool) {
+    p_obuf_dblk_t oldest = pool->oldest;
+    p_obuf_dblk_t head   = OBUF_SHARED(pool->newest);
+
+    REQUIRE (pool != NULL);
+    CPU_DMB;                                    // head is read before the blocks it publishes
+    if ((oldest != head) && OBUF_IS_FREED(oldest)) {  // unused end of pool
+        oldest = OBUF_NEXT(oldest);
+    }
+    return ((oldest == head) ? NULL : (void *) &(oldest->data));
+}
+
+
+obuf_error_t obufSpscFree(obuf_obj_t pool, void * ptr) {
+    char *        bot   = pool->buf;
+    char *        top   = bot + pool->size;
+    char *        data;
+
+    REQUIRE (pool != NULL);
+    if ((ptr >= ((void *) top)) || (ptr < ((void *) bot))) {
+        return (OBUF_NOERR);                    // not in the pool, ignored as by obufFree()
+    }
+    if (!(data = obufSpscOldest(pool)) || (ptr != (void *) data)) {
+        return (OBUF_INVALID_POINTER);          // empty pool, or not the oldest block
+    }
+    CPU_DMB;                                    // block is no longer accessed once it is released
+    OBUF_SHARED(pool->oldest) = OBUF_NEXT((p_obuf_dblk_t) (data - offsetof(struct obuf_dblk_t, data)));
+    return (OBUF_NOERR);
+}
+
+
+/*
+ * Return the first n_ptrs data pointers of the pool linked list that have not
+ * been freed. The ptr_array list must be sized to accept n_ptrs + 1. The
+ * ptr_array will be terminated with a NULL entry after the last valid data pointer.
  */
 void  obufDataPtrs(obuf_obj_t pool, void * ptr_array[], uint32_t n_ptrs) {
     p_obuf_dblk_t p_block;
+    uint32_t      n = 0;
 
     REQUIRE (pool != NULL);
     REQUIRE (ptr_array != NULL);
 
     LOCK;
-    if (pool->n_blks != 0) {             // pool not empty
-        p_block = pool->oldest;
-        for (int i=0; i<pool->n_blks; ++i) {
-            ptr_array[i] = (void *) &(p_block->data);
-            p_block = p_block->next;
+    p_block = pool->oldest;
+    for (mem_index_t i=0; (i<pool->n_blks) && (n<n_ptrs); ++i) {
+        if (!OBUF_IS_FREED(p_block)) {
+            ptr_array[n++] = (void *) &(p_block->data);
         }
+        p_block = OBUF_NEXT(p_block);
     }
-    ptr_array[pool->n_blks] = NULL;
+    ptr_array[n] = NULL;
     END_LOCK;
 }
 
@@ -602,7 +1391,7 @@ void obufMemStats(obuf_obj_t pool, int * min_free, int * failed_allocs) {
 
    FIFO: A fifo type that operates on chars. Thread safe.
 
-        Fifo size is limited to 64K Bytes.
+        Fifo size is limited to 64K Bytes (see MEMORY_INDEX_32).
         NEW_FIFO returns a pointer to the Fifo control structure (TFifo).
         Push and Pop are optimized for time for efficiency in irq handlers.
 
@@ -622,6 +1411,13 @@ void obufMemStats(obuf_obj_t pool, int * min_free, int * failed_allocs) {
     04/30/14  Incorporated into memory.c which includes general collection classes
     02/05/16  Added Push16/Pop16, Push32/Pop32, Push64/Pop64, PushN/PopN
     09/12/16  Separated struct TFifo from the data storage array to minimize size of initialization constant
+    10/16/26  PushN/PopN/PopOff copy at most two segments with a single index update
+    10/16/26  Added lock-free SPSC FIFO with free-running indices
+    10/16/26  Added NEW_FIFO_T typed fifo, fixed Pop16/Pop32/Pop64 writing to their own argument
+    10/16/26  Added fifoWriteSpan, fifoReadSpan, fifoCommitWrite, fifoConsume
+    10/16/26  fifoScan searches a word at a time, added fifoPopUntil
+    10/16/26  Added overwrite-oldest fifoPushOver, fifoPushNOver and the overwritten count
+    10/16/26  Added length-prefixed records recPush, recPeek, recPop
 
  *****************************************************************************/
 
@@ -650,32 +1446,94 @@ bool fifoPush(TFifo fifo, char c) {
 }
 
 
-bool  fifoPushN(TFifo fifo, uint16_t n, uint8_t * array) {
+/*
+ * Bulk transfers copy at most two contiguous segments, up to the end of the
+ * element array and then from its start, and update the index once.
+ */
+static fifo_index_t fifoCopyIn(TFifo fifo, fifo_index_t i, const uint8_t * src, uint32_t n) {
+    uint32_t  first = MIN(n, (uint32_t) (fifo->size - i));
+
+    memcpy(&fifo->element[i], src, first);
+    memcpy(fifo->element, src + first, n - first);
+    i = (first < n) ? (n - first) : (i + n);
+    return ((i == fifo->size) ? 0 : i);
+}
+
+
+static fifo_index_t fifoCopyOut(TFifo fifo, fifo_index_t i, uint8_t * dst, uint32_t n) {
+    uint32_t  first = MIN(n, (uint32_t) (fifo->size - i));
+
+    memcpy(dst, &fifo->element[i], first);
+    memcpy(dst + first, fifo->element, n - first);
+    i = (first < n) ? (n - first) : (i + n);
+    return ((i == fifo->size) ? 0 : i);
+}
+
+
+bool  fifoPushN(TFifo fifo, fifo_index_t n, uint8_t * array) {
     bool success = false;
     LOCK;
     if (fifoRemaining(fifo) >= n) {
+        fifo->head = fifoCopyIn(fifo, fifo->head, array, n);
+        fifo->entries += n;
         success = true;
-        for (uint16_t i=0; i<n; ++i) {
-            success &= fifoPush(fifo, array[i]);
-        }
     }
     END_LOCK;
     return (success);
 }
 
 
+/*
+ * Overwrite-oldest pushes never fail. The tail is advanced past the chars
+ * that do not fit, which are counted in overwritten.
+ */
+void fifoPushOver(TFifo fifo, char c) {
+    LOCK;
+    if (fifoFull(fifo)) {
+        if (++fifo->tail == fifo->size) { fifo->tail = 0; }
+        --fifo->entries;
+        ++fifo->overwritten;
+    }
+    fifo->element[fifo->head++] = c;
+    if (fifo->head == fifo->size) { fifo->head = 0; }
+    ++fifo->entries;
+    END_LOCK;
+}
+
+
+void  fifoPushNOver(TFifo fifo, fifo_index_t n, uint8_t * array) {
+    uint32_t  over, t;
+    LOCK;
+    if (n > fifo->size) {                       // only the last size chars are kept
+        fifo->overwritten += n - fifo->size;
+        array += n - fifo->size;
+        n = fifo->size;
+    }
+    if (n > fifoRemaining(fifo)) {
+        over = n - fifoRemaining(fifo);
+        t = (uint32_t) fifo->tail + over;
+        fifo->tail = (t >= fifo->size) ? (t - fifo->size) : t;
+        fifo->entries -= over;
+        fifo->overwritten += over;
+    }
+    fifo->head = fifoCopyIn(fifo, fifo->head, array, n);
+    fifo->entries += n;
+    END_LOCK;
+}
+
+
 bool  fifoPush16(TFifo fifo, uint16_t hw) {
-    return (fifoPushN(fifo, (uint16_t) sizeof(uint16_t), (uint8_t *) &hw));
+    return (fifoPushN(fifo, (fifo_index_t) sizeof(uint16_t), (uint8_t *) &hw));
 }
 
 
 bool  fifoPush32(TFifo fifo, uint32_t w) {
-    return (fifoPushN(fifo, (uint16_t) sizeof(uint32_t), (uint8_t *) &w));
+    return (fifoPushN(fifo, (fifo_index_t) sizeof(uint32_t), (uint8_t *) &w));
 }
 
 
 bool  fifoPush64(TFifo fifo, uint64_t ll) {
-    return (fifoPushN(fifo, (uint16_t) sizeof(uint64_t), (uint8_t *) &ll));
+    return (fifoPushN(fifo, (fifo_index_t) sizeof(uint64_t), (uint8_t *) &ll));
 }
 
 
@@ -689,13 +1547,145 @@ bool fifoPushStr(TFifo fifo, char * str) {
 }
 
 
-bool fifoPop(TFifo fifo, char *c) {
-    bool success = false;
+bool fifoPop(TFifo fifo, char *c) {
+    bool success = false;
+    LOCK;
+    if (!fifoEmpty(fifo)) {
+        *c = fifo->element[fifo->tail++];
+        if (fifo->tail == fifo->size) { fifo->tail = 0; }
+        --fifo->entries;
+        success = true;
+    }
+    END_LOCK;
+    return (success);
+}
+
+
+bool  fifoPopN(TFifo fifo, fifo_index_t n, uint8_t * array) {
+    bool success = false;
+    LOCK;
+    if (!fifoEmpty(fifo)) {         // pops as many as are available, fails if fewer than n
+        success = (fifo->entries >= n);
+        n = MIN(n, fifo->entries);
+        fifo->tail = fifoCopyOut(fifo, fifo->tail, array, n);
+        fifo->entries -= n;
+    }
+    END_LOCK;
+    return (success);
+}
+
+
+bool  fifoPop16(TFifo fifo, uint16_t * hw) {
+    return (fifoPopN(fifo, (fifo_index_t) sizeof(uint16_t), (uint8_t *) hw));
+}
+
+
+bool  fifoPop32(TFifo fifo, uint32_t * w) {
+    return (fifoPopN(fifo, (fifo_index_t) sizeof(uint32_t), (uint8_t *) w));
+}
+
+
+bool  fifoPop64(TFifo fifo, uint64_t * ll) {
+    return (fifoPopN(fifo, (fifo_index_t) sizeof(uint64_t), (uint8_t *) ll));
+}
+
+
+bool fifoPopStr(TFifo fifo, char * str, fifo_index_t n) {
+    bool success = fifoPopN(fifo, n, (uint8_t *) str);
+    str[n] = '\0';
+    return (success);
+}
+
+
+void fifoFill(TFifo fifo, char c) {
+    while (!fifoFull(fifo)) { (void) fifoPush(fifo, c); }
+}
+
+
+void fifoPopOff(TFifo fifo, fifo_index_t n) {
+    uint32_t  t;
+    LOCK;
+    n = MIN(n, fifo->entries);
+    t = (uint32_t) fifo->tail + n;
+    fifo->tail = (t >= fifo->size) ? (t - fifo->size) : t;
+    fifo->entries -= n;
+    END_LOCK;
+}
+
+
+char * fifoWriteSpan(TFifo fifo, fifo_index_t * n) {
+    LOCK;
+    *n = MIN(fifoRemaining(fifo), fifo->size - fifo->head);
+    END_LOCK;
+    return (&fifo->element[fifo->head]);
+}
+
+
+char * fifoReadSpan(TFifo fifo, fifo_index_t * n) {
+    LOCK;
+    *n = MIN(fifoEntries(fifo), fifo->size - fifo->tail);
+    END_LOCK;
+    return (&fifo->element[fifo->tail]);
+}
+
+
+void fifoCommitWrite(TFifo fifo, fifo_index_t n) {
+    uint32_t  h;
+    LOCK;
+    REQUIRE (n <= fifoRemaining(fifo));
+    h = (uint32_t) fifo->head + n;
+    fifo->head = (h >= fifo->size) ? (h - fifo->size) : h;
+    fifo->entries += n;
+    END_LOCK;
+}
+
+
+void fifoConsume(TFifo fifo, fifo_index_t n) {
+    REQUIRE (n <= fifoEntries(fifo));
+    fifoPopOff(fifo, n);
+}
+
+
+#define REC_HEADER_SIZE   sizeof(uint16_t)
+
+/* length of the record at tail, the fifo must not be empty */
+static fifo_index_t recLength(TFifo fifo) {
+    fifo_index_t  t = (fifo->tail + 1 == fifo->size) ? 0 : fifo->tail + 1;
+    return ((fifo_index_t) ((uint8_t) fifo->element[fifo->tail] | ((uint8_t) fifo->element[t] << 8)));
+}
+
+
+bool recPush(TFifo fifo, const void * ptr, fifo_index_t len) {
+    uint8_t   hdr[REC_HEADER_SIZE] = { (uint8_t) len, (uint8_t) (len >> 8) };
+    bool      success = false;
+
+    #ifdef MEMORY_INDEX_32
+        REQUIRE (len <= UINT16_MAX);
+    #endif
+    LOCK;
+    if ((uint32_t) fifoRemaining(fifo) >= ((uint32_t) len + sizeof(hdr))) {
+        fifo->head = fifoCopyIn(fifo, fifo->head, hdr, sizeof(hdr));
+        fifo->head = fifoCopyIn(fifo, fifo->head, ptr, len);
+        fifo->entries += len + sizeof(hdr);
+        success = true;
+    }
+    END_LOCK;
+    return (success);
+}
+
+
+bool recPeek(TFifo fifo, char ** p0, fifo_index_t * n0, char ** p1, fifo_index_t * n1) {
+    fifo_index_t  len, data;
+    bool          success = false;
     LOCK;
     if (!fifoEmpty(fifo)) {
-        *c = fifo->element[fifo->tail++];
-        if (fifo->tail == fifo->size) { fifo->tail = 0; }
-        --fifo->entries;
+        len  = recLength(fifo);
+        data = fifo->tail + REC_HEADER_SIZE;
+        if (data >= fifo->size) { data -= fifo->size; }
+        *p0  = &fifo->element[data];
+        *n0  = MIN(len, fifo->size - data);
+        *p1  = fifo->element;
+        *n1  = len - *n0;
         success = true;
     }
     END_LOCK;
@@ -703,83 +1693,152 @@ bool fifoPop(TFifo fifo, char *c) {
 }
 
 
-bool  fifoPopN(TFifo fifo, uint16_t n, uint8_t * array) {
-    bool success = false;
+bool recPop(TFifo fifo) {
+    bool      success = false;
     LOCK;
     if (!fifoEmpty(fifo)) {
+        fifoPopOff(fifo, recLength(fifo) + REC_HEADER_SIZE);
         success = true;
-        for (uint16_t i=0; i<n; ++i) {
-            success &= fifoPop(fifo, (char *) &array[i]);
-        }
     }
     END_LOCK;
     return (success);
 }
 
 
-bool  fifoPop16(TFifo fifo, uint16_t * hw) {
-    return (fifoPopN(fifo, (uint16_t) sizeof(uint16_t), (uint8_t *) &hw));
+bool fifoArray(TFifo fifo, char *c, int32_t i) {
+    bool  success = false;
+    LOCK;
+    if (i < 0) { i += fifo->entries; }					    /* index from end of array */
+    if ((i >= 0) && ((uint32_t) i < fifo->entries)) {	/* index within range */
+        uint32_t  n = (uint32_t) i + fifo->tail;
+        if (n >= fifo->size) { n -= fifo->size; }   /* modulo fifo.size */
+        *c = fifo->element[n];
+        success = true;
+    }
+    END_LOCK;
+	return (success);
 }
 
 
-bool  fifoPop32(TFifo fifo, uint32_t * w) {
-    return (fifoPopN(fifo, (uint16_t) sizeof(uint32_t), (uint8_t *) &w));
+/*
+ * Return the index of the first c in n chars at p, or n if there is none.
+ * Aligned words are searched four chars at a time by xoring with c in every
+ * byte and testing the result for a zero byte.
+ */
+static uint32_t fifoFindChar(const char * p, uint32_t n, char c) {
+    uint32_t  i = 0;
+    uint32_t  w, pattern = 0x01010101u * (uint8_t) c;
+
+    while ((i < n) && ((uintptr_t) &p[i] & 3)) {      // up to word alignment
+        if (p[i] == c) { return (i); }
+        ++i;
+    }
+    while ((i + 4) <= n) {
+        memcpy(&w, &p[i], sizeof(w));                   // a single aligned load
+        w ^= pattern;
+        if ((w - 0x01010101u) & ~w & 0x80808080u) { break; }  // c is in this word
+        i += 4;
+    }
+    while ((i < n) && (p[i] != c)) { ++i; }
+    return (i);
 }
 
 
-bool  fifoPop64(TFifo fifo, uint64_t * ll) {
-    return (fifoPopN(fifo, (uint16_t) sizeof(uint64_t), (uint8_t *) &ll));
+/* offset from tail of the first c within the first n entries, or n if there is none */
+static uint32_t fifoFind(TFifo fifo, char c, uint32_t n) {
+    uint32_t  first = MIN(n, (uint32_t) (fifo->size - fifo->tail));
+    uint32_t  i     = fifoFindChar(&fifo->element[fifo->tail], first, c);
+
+    if (i == first) {                                   // not in the first segment
+        i += fifoFindChar(fifo->element, n - first, c);
+    }
+    return (i);
 }
 
 
-bool fifoPopStr(TFifo fifo, char * str, uint16_t n) {
-    bool success = fifoPopN(fifo, n, (uint8_t *) str);
-    str[n] = '\0';
+bool fifoScan(TFifo fifo, char c) {
+    bool      success;
+    LOCK;
+    success = (fifoFind(fifo, c, fifo->entries) < fifo->entries);
+    END_LOCK;
     return (success);
 }
 
 
-void fifoFill(TFifo fifo, char c) {
-    while (!fifoFull(fifo)) { (void) fifoPush(fifo, c); }
+fifo_index_t fifoPopUntil(TFifo fifo, char delim, char * buf, fifo_index_t max) {
+    uint32_t  n = 0;
+    LOCK;
+    if ((n = fifoFind(fifo, delim, MIN(max, fifo->entries))) < MIN(max, fifo->entries)) {
+        ++n;                                            // include the delimiter
+        fifo->tail = fifoCopyOut(fifo, fifo->tail, (uint8_t *) buf, n);
+        fifo->entries -= n;
+    }
+    else {
+        n = 0;
+    }
+    END_LOCK;
+    return ((fifo_index_t) n);
 }
 
 
-void fifoPopOff(TFifo fifo, fifo_index_t n) {
-    char	c;
-    while (n-- > 0) { (void) fifoPop(fifo, &c); }
+/*
+ * SPSC FIFO. Each side reads the other side's index once. The element is
+ * written (read) before head (tail) is advanced, with a barrier between
+ * them, so the other side never sees an index ahead of the data.
+ */
+bool fifoSpscPush(TSpscFifo fifo, char c) {
+    fifo_index_t  head = fifo->head;
+
+    if ((fifo_index_t) (head - fifo->tail) > fifo->mask) { return (false); }
+    CPU_DMB;                                    // tail is read before its element is overwritten
+    fifo->element[head & fifo->mask] = c;
+    CPU_DMB;
+    fifo->head = head + 1;
+    return (true);
 }
 
 
-bool fifoArray(TFifo fifo, char *c, int32_t i) {
-    bool  success = false;
-    LOCK;
-    if (i < 0) { i += fifo->entries; }					    /* index from end of array */
-    if ((i >= 0) && (i < fifo->entries)) {	        /* index within range */
-        i += fifo->tail;
-        if (i >= fifo->size) { i -= fifo->size; }   /* modulo fifo.size */
-        *c = fifo->element[i];
-        success = true;
-    }
-    END_LOCK;
-	return (success);
+bool fifoSpscPushN(TSpscFifo fifo, fifo_index_t n, uint8_t * array) {
+    fifo_index_t  head = fifo->head;
+    fifo_index_t  i    = head & fifo->mask;
+    uint32_t      first;
+
+    if ((uint32_t) (fifo->mask + 1 - (fifo_index_t) (head - fifo->tail)) < n) { return (false); }
+    CPU_DMB;                                    // tail is read before its elements are overwritten
+    first = MIN(n, (uint32_t) (fifo->mask + 1 - i));
+    memcpy(&fifo->element[i], array, first);
+    memcpy(fifo->element, array + first, n - first);
+    CPU_DMB;
+    fifo->head = head + n;
+    return (true);
 }
 
 
-bool fifoScan(TFifo fifo, char c) {
-    fifo_index_t  t, e;
-    bool      success = false;
-    LOCK;
-    t = fifo->tail;
-    e = fifo->entries;
-    while (e--) {
-        if (fifo->element[t] == c) {
-            success = true;
-            break;
-        }
-        t = (t + 1) % fifo->size;
-    }
-    END_LOCK;
-    return (success);
+bool fifoSpscPop(TSpscFifo fifo, char * c) {
+    fifo_index_t  tail = fifo->tail;
+
+    if (fifo->head == tail) { return (false); }
+    CPU_DMB;
+    *c = fifo->element[tail & fifo->mask];
+    CPU_DMB;
+    fifo->tail = tail + 1;
+    return (true);
+}
+
+
+bool fifoSpscPopN(TSpscFifo fifo, fifo_index_t n, uint8_t * array) {
+    fifo_index_t  tail = fifo->tail;
+    fifo_index_t  i    = tail & fifo->mask;
+    uint32_t      first;
+
+    if ((fifo_index_t) (fifo->head - tail) < n) { return (false); }
+    CPU_DMB;
+    first = MIN(n, (uint32_t) (fifo->mask + 1 - i));
+    memcpy(array, &fifo->element[i], first);
+    memcpy(array + first, fifo->element, n - first);
+    CPU_DMB;
+    fifo->tail = tail + n;
+    return (true);
 }
 
 
@@ -807,8 +1866,319 @@ bool fifoScan(TFifo fifo, char c) {
 #define POOL_PARTITION_512_BLOCKS     0
 #define POOL_PARTITION_1024_BLOCKS    0
  *
+ * and POOL_CLASS_n must be the default powers of two.
+ */
+
+
+/*
+ * CAS hooks called by cpuCAS. pool_isr simulates an interrupt that runs
+ * before the pool_isr_cas'th CAS operation from now.
  */
+static void (* pool_isr)(void);
+static int     pool_isr_cas;
+
+void test_preCAS(void) {
+    void (* isr)(void) = pool_isr;
+    if (isr && (pool_isr_cas-- == 0)) {
+        pool_isr = NULL;
+        isr();
+    }
+}
+
+void test_postCAS(void) { }
+
+int test_CAS_OP(uint32_t volatile * const addr, uint32_t const expected, uint32_t const store) {
+    if (*addr != expected) { return (1); }
+    *addr = store;
+    return (0);
+}
+
+#define POOL_TEST_SPEC    0, 0, 0, 40, 0, 0, 0, 1     // 40 blocks spans two allocation words
+
+NEW_POOL(pool_a, POOL_TEST_SPEC);
+NEW_POOL(pool_b, 2, 0, 0, 0, 0, 0, 0, 0);
+
+NEW_POOL(pool_c, 2, 0, 0, 0, 0, 0, 0, 0);
+
+static void *  pool_isr_blk;
+static void    poolIsrMalloc(void) { pool_isr_blk = poolMallocFrom(pool_c, 8); }
+static void    poolIsrFree(void)   { poolFreeTo(pool_c, pool_isr_blk); }
+
+/* an interrupt allocating or freeing in the middle of a lockless operation */
+static int testPoolInterrupted(void) {
+    bool  pass = TRUE;
+    void  *blk0, *blk1;
+
+    /* interrupt claims the block found by the search, search is retried */
+    pool_isr = poolIsrMalloc; pool_isr_cas = 0;
+    blk0 = poolMallocFrom(pool_c, 8);
+    pass &= !!blk0 && !!pool_isr_blk && (blk0 != pool_isr_blk);
+    pass &= poolProfileOf(pool_c)->pool_state[0] == 0x00000003;
+    pass &= !poolMallocFrom(pool_c, 8);                     // full, and marked full
+    pass &= pool_c->full == 0xff;
+    pass &= poolProfileOf(pool_c)->pool_stat[0].cur_alloc == 2;
+
+    /* interrupt frees the only allocated block while the last free block is claimed */
+    poolFreeTo(pool_c, blk0);
+    pool_isr = poolIsrFree; pool_isr_cas = 0;
+    blk1 = poolMallocFrom(pool_c, 8);                       // CAS fails, retry claims the block just freed
+    pass &= (blk1 == pool_isr_blk);
+    pass &= poolProfileOf(pool_c)->pool_state[0] == 0x00000001;
+    pass &= pool_c->summary[0] == 0;
+
+    /* interrupt frees a block while the word is being marked full */
+    pool_isr_blk = blk1;
+    pool_isr = poolIsrFree; pool_isr_cas = 1;               // after claiming the last block, before marking the word full
+    blk0 = poolMallocFrom(pool_c, 8);
+    pass &= !!blk0 && (blk0 != blk1);
+    pass &= poolProfileOf(pool_c)->pool_state[0] == (blk0 == pool_c->mem ? 0x00000001 : 0x00000002);
+    pass &= pool_c->summary[0] == 0;                        // full hint withdrawn
+    pass &= (pool_c->full & 1) == 0;
+    pass &= !!poolMallocFrom(pool_c, 8);                    // the freed block is found
+    pass &= !poolMallocFrom(pool_c, 8);
+    pass &= poolProfileOf(pool_c)->pool_stat[0].cur_alloc == 2;
+    pass &= poolProfileOf(pool_c)->pool_stat[0].max_alloc == 2;
+
+    return ((int) !pass);
+}
+
+/* pools are independent of each other and of the default pool */
+static int testPoolInstances(void) {
+    bool  pass = TRUE;
+    void  *blk_a[41], *blk_b[2];
+    int   i;
+
+    for (i=0; i<40; ++i) {                                  // 64 byte partition, both allocation words
+        pass &= !!(blk_a[i] = poolMallocFrom(pool_a, 1));
+    }
+    pass &= (char *) blk_a[39] == (char *) blk_a[0] + (39 * 64);
+    pass &= !!(blk_a[40] = poolMallocFrom(pool_a, 1));      // spills to the 1024 byte block
+    pass &= !poolMallocFrom(pool_a, 1);                     // pool_a exhausted
+    pass &= poolProfileOf(pool_a)->pool_state[0] == 0xffffffff;
+    pass &= poolProfileOf(pool_a)->pool_state[1] == 0x000000ff;
+    pass &= poolProfileOf(pool_a)->pool_state[2] == 0x00000001;
+
+    pass &= !!(blk_b[0] = poolMallocFrom(pool_b, 8));       // pool_b unaffected by pool_a
+    pass &= !!(blk_b[1] = poolMallocFrom(pool_b, 8));
+    pass &= !poolMallocFrom(pool_b, 8);
+    pass &= !poolMallocFrom(pool_b, 9);                     // no partition large enough
+
+    poolFreeTo(pool_b, blk_a[0]);                           // block of another pool is ignored
+    pass &= poolProfileOf(pool_a)->pool_state[0] == 0xffffffff;
+
+    poolFreeTo(pool_a, blk_a[35]);                          // free in the second allocation word
+    pass &= poolMallocFrom(pool_a, 64) == blk_a[35];
+    poolFreeTo(pool_a, blk_a[40]);
+    pass &= poolMallocFrom(pool_a, 65) == blk_a[40];
+
+    for (i=0; i<41; ++i) {
+        poolFreeTo(pool_a, blk_a[i]);
+    }
+    pass &= poolProfileOf(pool_a)->pool_stat[3].cur_alloc == 0;
+    pass &= poolProfileOf(pool_a)->pool_stat[3].max_alloc == 40;
+    pass &= poolProfileOf(pool_b)->pool_stat[0].cur_alloc == 2;
+
+    return ((int) !pass);
+}
+
+/* best fit lookup and address translation agree with the class table */
+static int testPoolClasses(void) {
+    bool      pass = TRUE;
+    int       p, q, blk, n;
+    uint32_t  waste, requested;
+    char *    addr;
+
+    for (size_t size=1; size<=POOL_CLASS_7; ++size) {
+        p = poolBestFitIndex(size);
+        pass &= (poolPartitionAtIndex(p) >= size) && (poolPartitionAtIndex(p-1) < size);
+    }
+    pass &= poolBestFitIndex(0) == 0;
+    pass &= poolBestFitIndex(POOL_CLASS_7 + 1) == -1;
+
+    for (p=0; p<POOL_PARTITIONS; ++p) {
+        for (n=0; n<g_pool->geometry->blocks[p]; ++n) {
+            addr = &g_pool->mem[g_pool->geometry->offset[p] + (n * pool_class[p])];
+            pass &= poolBlkAtAddr(g_pool, addr, &q, &blk) && (q == p) && (blk == n);
+            pass &= !poolBlkAtAddr(g_pool, addr + 4, &q, &blk);
+        }
+    }
+
+    waste     = pool_a->stat[3].waste;                      // 64 byte partition
+    requested = pool_a->stat[3].requested;
+    addr      = poolMallocFrom(pool_a, 20);
+    pass &= pool_a->stat[3].waste == waste + (POOL_CLASS_3 - 20);
+    pass &= pool_a->stat[3].requested == requested + 20;
+    poolFreeTo(pool_a, addr);
+
+    return ((int) !pass);
+}
+
+#if POOL_CLASSES_POW2                         // buddy pools require the default classes
+
+#define POOL_BUDDY_SPEC   2, 0, 0, 0, 0, 0, 0, 1
+
+NEW_BUDDY_POOL(pool_d, POOL_BUDDY_SPEC);
+
+/* buddy pool splits the 1024 byte block on demand and merges it back on free */
+static int testPoolBuddy(void) {
+    bool  pass = TRUE;
+    char  *mem = pool_d->mem;
+    void  *blk[8];
+    int   i, splits = 0, merges = 0;
+    pool_profile_t * prof = poolProfileOf(pool_d);
+
+    pass &= (blk[0] = poolMallocFrom(pool_d, 8)) == mem + 1024;   // native 8 byte blocks first
+    pass &= (blk[1] = poolMallocFrom(pool_d, 8)) == mem + 1032;
+    pass &= (blk[2] = poolMallocFrom(pool_d, 1)) == mem;          // 1024 split down to 8
+    pass &= (blk[3] = poolMallocFrom(pool_d, 8)) == mem + 8;      // free halves, smallest first
+    pass &= (blk[4] = poolMallocFrom(pool_d, 16)) == mem + 16;
+    pass &= !poolMallocFrom(pool_d, 1024);                        // 1024 byte block is split
+    pass &= (blk[5] = poolMallocFrom(pool_d, 512)) == mem + 512;
+    pass &= !poolMallocFrom(pool_d, 512);
+    pass &= (blk[6] = poolMallocFrom(pool_d, 256)) == mem + 256;
+    pass &= prof->pool_state[1] == 0x00000001;                    // 1024 byte block allocated once
+    pass &= prof->pool_stat[0].cur_alloc == 4;
+    for (i=0; i<POOL_PARTITIONS; ++i) {
+        splits += prof->pool_stat[i].cnt_split;
+    }
+    pass &= splits == 7;
+
+    poolFreeTo(pool_d, mem + 4);                                  // middle of a split block, ignored
+    pass &= prof->pool_stat[0].cur_alloc == 4;
+
+    poolFreeTo(pool_d, blk[2]);                                   // buddy in use, not merged
+    poolFreeTo(pool_d, blk[2]);                                   // already free, ignored
+    pass &= prof->pool_stat[0].cur_alloc == 3;
+    pass &= prof->pool_stat[1].cnt_merge == 0;
+    poolFreeTo(pool_d, blk[3]);                                   // merge 8 + 8
+    pass &= prof->pool_stat[1].cnt_merge == 1;
+    poolFreeTo(pool_d, blk[4]);                                   // merge up to 256
+    poolFreeTo(pool_d, blk[6]);
+    poolFreeTo(pool_d, blk[5]);                                   // merge back into the 1024 byte block
+    pass &= prof->pool_state[1] == 0x00000000;
+    for (i=0; i<POOL_PARTITIONS; ++i) {
+        merges += prof->pool_stat[i].cnt_merge;
+        pass &= prof->pool_stat[i].cur_alloc == (i ? 0 : 2);
+    }
+    pass &= merges == 7;
+    for (i=0; i<(int) (sizeof(_pool_buddy_pool_d) / sizeof(uint32_t)); ++i) {
+        pass &= pool_d->buddy[i] == 0;                            // no split or free half left
+    }
+
+    pass &= (blk[7] = poolMallocFrom(pool_d, 1024)) == mem;
+    poolFreeTo(pool_d, blk[7]);
+    poolFreeTo(pool_d, blk[0]);
+    poolFreeTo(pool_d, blk[1]);
+    pass &= prof->pool_state[0] == 0x00000000;
+
+    return ((int) !pass);
+}
+
+/* a buddy block shrinks in place, releasing its upper halves */
+static int testPoolBuddyRealloc(void) {
+    bool  pass = TRUE;
+    char  *mem = pool_d->mem;
+    void  *blk0, *blk1;
+    pool_stats_t  stat = poolProfileOf(pool_d)->pool_stat[0];
+
+    pass &= (blk0 = poolMallocFrom(pool_d, 1024)) == mem;
+    pass &= poolReallocFrom(pool_d, blk0, 6) == mem;
+    pass &= poolProfileOf(pool_d)->pool_stat[0].cur_alloc == 1;
+    pass &= poolProfileOf(pool_d)->pool_stat[0].cnt_alloc == stat.cnt_alloc + 1;
+    pass &= poolProfileOf(pool_d)->pool_stat[0].requested == stat.requested + 6;
+    pass &= poolProfileOf(pool_d)->pool_stat[0].waste == stat.waste + 2;
+    pass &= poolProfileOf(pool_d)->pool_stat[7].cur_alloc == 0;
+    pass &= (blk1 = poolMallocFrom(pool_d, 512)) == mem + 512;
+    poolFreeTo(pool_d, blk0);
+    poolFreeTo(pool_d, blk1);
+    for (int i=0; i<(int) (sizeof(_pool_buddy_pool_d) / sizeof(uint32_t)); ++i) {
+        pass &= pool_d->buddy[i] == 0;
+    }
+    pass &= poolProfileOf(pool_d)->pool_state[1] == 0;
+
+    return ((int) !pass);
+}
+#endif
+
+/* realloc keeps, moves or releases blocks of pool_a: 40 x 64 and 1 x 1024 bytes */
+static int testPoolRealloc(void) {
+    bool  pass = TRUE;
+    char  *blk0, *blk1, *blk2;
+    pool_profile_t * prof = poolProfileOf(pool_a);
+
+    pass &= !!(blk0 = poolReallocFrom(pool_a, NULL, 10));    // malloc
+    memset(blk0, 0x5a, 10);
+    pass &= poolReallocFrom(pool_a, blk0, 64) == blk0;       // still fits
+    pass &= !!(blk1 = poolReallocFrom(pool_a, blk0, 100));   // grow to the 1024 byte block
+    pass &= (blk1 != blk0) && (blk1[0] == 0x5a) && (blk1[9] == 0x5a);
+    pass &= prof->pool_stat[3].cur_alloc == 0;
+    pass &= prof->pool_stat[7].cur_alloc == 1;
+    pass &= !poolReallocFrom(pool_a, blk1, 2048);            // too large, block kept
+    pass &= prof->pool_stat[7].cur_alloc == 1;
+    pass &= !!(blk2 = poolReallocFrom(pool_a, blk1, 30));    // shrink, releases the 1024 byte block
+    pass &= (blk2 != blk1) && (blk2[9] == 0x5a);
+    pass &= prof->pool_stat[7].cur_alloc == 0;
+    pass &= !poolReallocFrom(pool_a, blk2 + 4, 8);           // not a block
+    pass &= !poolReallocFrom(pool_a, blk1, 8);               // not allocated
+    pass &= !poolReallocFrom(pool_a, blk2, 0);               // free
+    pass &= prof->pool_stat[3].cur_alloc == 0;
+
+    #if POOL_CLASSES_POW2
+        pass &= !testPoolBuddyRealloc();
+    #endif
+
+    return ((int) !pass);
+}
+
+static int  pool_dump_lines[4];     // POOL, CLASS, HIST, END lines
+
+static int poolDumpPrint(const char * fmt, ...) {
+    static const char * tag[4] = { "POOL", "CLASS", "HIST", "END" };
+    for (int i=0; i<4; ++i) {
+        if (!strncmp(fmt, tag[i], strlen(tag[i]))) { ++pool_dump_lines[i]; }
+    }
+    return ((int) strlen(fmt));
+}
+
+/* dump has one CLASS line per partition and 16 history entries per HIST line */
+static int testPoolDump(void) {
+    bool      pass = TRUE;
+    uint32_t  cnt  = MIN(pool_a->history_cnt, POOL_HISTORY_DEPTH);
+
+    poolDumpOf(pool_a, poolDumpPrint);
+    pass &= pool_dump_lines[0] == 1;
+    pass &= pool_dump_lines[1] == POOL_PARTITIONS;
+    pass &= pool_dump_lines[2] == (int) ((cnt + 15) / 16);
+    pass &= pool_dump_lines[3] == 1;
+
+    return ((int) !pass);
+}
+
+/* every call is timed, POOL_CYCLES advances 7 cycles per read */
+static int testPoolTiming(void) {
+    bool  pass = TRUE;
+
+    #ifdef POOL_TIMING
+        pool_profile_t * prof = poolProfileOf(pool_a);
+        uint32_t  n_malloc = prof->pool_timing[POOL_TIMING_MALLOC].cnt;
+        uint32_t  n_free   = prof->pool_timing[POOL_TIMING_FREE].cnt;
+
+        poolFreeTo(pool_a, poolMallocFrom(pool_a, 8));
+        (void) poolMallocFrom(pool_a, 2048);                    // too large, still timed
+        pass &= prof->pool_timing[POOL_TIMING_MALLOC].cnt == n_malloc + 2;
+        pass &= prof->pool_timing[POOL_TIMING_FREE].cnt   == n_free + 1;
+        for (int op=POOL_TIMING_MALLOC; op<=POOL_TIMING_FREE; ++op) {
+            pass &= prof->pool_timing[op].min == 7;
+            pass &= prof->pool_timing[op].max == 7;
+            pass &= prof->pool_timing[op].total == (7 * prof->pool_timing[op].cnt);
+        }
+    #endif
+
+    return ((int) !pass);
+}
 
+/* allocation word of the first (and only) word of each partition */
+#define POOL_STATE(p)   (prof->pool_state[g_pool->geometry->word[p]])
 
 int pool_UNIT_TEST(void) {
     bool  pass = TRUE;
@@ -830,10 +2200,12 @@ int pool_UNIT_TEST(void) {
     pass &= !!(p_blk[32] = poolMalloc(256));
     pass &= !poolMalloc(512);   // returns NULL
     pass &= !poolMalloc(1024);  // returns NULL
+    pass &= !poolMalloc(1025);  // returns NULL
 
     prof = poolProfile();
-    pass &= *(prof->pool_state) == 0x0000000100010115LL;
-
+    for (i=0; i<6; ++i) {
+        pass &= POOL_STATE(i) == 0x00000001;
+    }
 
     /* allocate all of the 8 byte blocks */
     for (i=1; i<8; ++i) {
@@ -842,39 +2214,64 @@ int pool_UNIT_TEST(void) {
     for (i=8; i<POOL_PARTITION_8_BLOCKS; ++i) {
         pass &= !!(p_blk[i] = poolMalloc(8));
     }
-    pass &= *(prof->pool_state) == 0x00000001ffff0115LL;
+    pass &= POOL_STATE(0) == 0x0000ffff;
+    pass &= (char *) p_blk[15] == (char *) p_blk[0] + (15 * 8);   // blocks are allocated in address order
 
     /* try one more small block, will allocate a 16 byte block */
     pass &= !!(p_blk[17] = poolMalloc(1));
-    pass &= *(prof->pool_state) == 0x00000001ffff8115LL;
+    pass &= POOL_STATE(0) == 0x0000ffff;
+    pass &= POOL_STATE(1) == 0x00000003;
+    pass &= (char *) p_blk[17] == (char *) p_blk[16] + 16;
 
     /* 22 blocks allocated already, allocate all remaining blocks */
     for (i=22; i<POOL_BLOCKS; ++i) {
         pass &= !!poolMalloc(1);
     }
-    pass &= *(prof->pool_state) == 0x00000001ffffffffLL;
+    pass &= POOL_STATE(0) == 0x0000ffff;
+    pass &= POOL_STATE(1) == 0x000000ff;
+    pass &= POOL_STATE(2) == 0x0000000f;
+    pass &= POOL_STATE(3) == 0x00000003;
+    pass &= POOL_STATE(4) == 0x00000003;
+    pass &= POOL_STATE(5) == 0x00000001;
 
     /* memory pool exhausted */
     pass &= !poolMalloc(1);
 
     /* free a NULL pointer, should be ignored */
     poolFree(NULL);
-    pass &= *(prof->pool_state) == 0x00000001ffffffffLL;
-
+    pass &= POOL_STATE(0) == 0x0000ffff;
 
     /* free a nonsense pointer, should be ignored */
     poolFree((void *) prof);
-    pass &= *(prof->pool_state) == 0x00000001ffffffffLL;
+    pass &= POOL_STATE(0) == 0x0000ffff;
+
+    /* free a pointer into the middle of a block, should be ignored */
+    poolFree((char *) p_blk[32] + 8);
+    pass &= POOL_STATE(5) == 0x00000001;
 
     /* free the 8 byte partition */
     for (i=0; i<POOL_PARTITION_8_BLOCKS; ++i) {
         poolFree(p_blk[i]);
     }
-    pass &= *(prof->pool_state) == 0x000000000001ffffLL;
+    pass &= POOL_STATE(0) == 0x00000000;
+    pass &= prof->pool_stat[0].cur_alloc == 0;
+    pass &= prof->pool_stat[0].max_alloc == POOL_PARTITION_8_BLOCKS;
 
-    /* free the second 16 byte block */
+    /* free the second 16 byte block, it is the next to be allocated */
     poolFree(p_blk[17]);
-    pass &= *(prof->pool_state) == 0x0000000000017fffLL;
+    pass &= POOL_STATE(1) == 0x000000fd;
+    pass &= poolMalloc(9) == p_blk[17];
+    pass &= POOL_STATE(1) == 0x000000ff;
+
+    pass &= !testPoolInstances();
+    pass &= !testPoolInterrupted();
+    #if POOL_CLASSES_POW2
+        pass &= !testPoolBuddy();
+    #endif
+    pass &= !testPoolClasses();
+    pass &= !testPoolDump();
+    pass &= !testPoolTiming();
+    pass &= !testPoolRealloc();
 
     return ((int) !pass);
 }
@@ -923,6 +2320,15 @@ NEW_DELAY_LINE(dl_10_char, char, 10);
 
 NEW_DELAY_LINE(dl_10_struct, mem_dl_struct_t, 10);
 
+NEW_MIRRORED_DELAY_LINE(dl_5_mirror, int32_t, 5);
+NEW_DELAY_LINE(dl_5_int32, int32_t, 5);
+NEW_MIRRORED_DELAY_LINE(dl_5_mirror_n, int32_t, 5);
+NEW_DELAY_LINE(dl_5_int32_n, int32_t, 5);
+NEW_DELAY_LINE(dl_5_ref, int32_t, 5);
+NEW_DELAY_LINE(dl_6_char, char, 6);
+NEW_DELAY_LINE(dl_6_char_n, char, 6);
+NEW_DELAY_LINE(dl_3_int64, int64_t, 3);                // 8 byte aligned elements
+
 
 int dl_UNIT_TEST(void) {
     bool  pass = TRUE;
@@ -981,6 +2387,52 @@ int dl_UNIT_TEST(void) {
     char * dl_10_char_array = dlAsArray(dl_10_char);
     pass &= (memcmp(dl_10_char_array, &dl_init_str_11, sizeof(dl_init_str_10)) == 0);
 
+    /* mirrored, the window matches the taps of an ordinary delay line at every index */
+    for (int32_t n=1; n<=12; ++n) {
+        dlUpdate(dl_5_mirror, &n);
+        dlUpdate(dl_5_int32, &n);
+        int32_t * window = dlWindow(dl_5_mirror);
+        for (int tap=0; tap<5; ++tap) {
+            pass &= (window[tap] == *(int32_t *) dlGetTap(dl_5_int32, tap));
+            pass &= (window[tap] == *(int32_t *) dlGetTap(dl_5_mirror, tap));
+        }
+        pass &= (window[0] == n) && (*(int32_t *) dlGetTap(dl_5_mirror, -1) == ((n > 4) ? (n - 4) : 0));
+    }
+    pass &= (dlAsArray(dl_5_mirror) == dlWindow(dl_5_mirror));
+
+    /* dlUpdateN(), blocks smaller, equal to and larger than the taps have the same taps as dlUpdate */
+    const mem_index_t block_n[] = { 0, 1, 2, 3, 4, 5, 6, 7, 11, 1, 4 };
+    int32_t block[11];
+    char    block_c[11];
+    int32_t next = 100;
+    for (unsigned b=0; b<(sizeof(block_n)/sizeof(block_n[0])); ++b) {
+        for (mem_index_t i=0; i<block_n[b]; ++i, ++next) {
+            block[i]   = next;
+            block_c[i] = (char) next;
+            dlUpdate(dl_5_ref, &block[i]);
+            dlUpdate(dl_6_char, &block_c[i]);
+        }
+        dlUpdateN(dl_5_int32_n, block, block_n[b]);
+        dlUpdateN(dl_5_mirror_n, block, block_n[b]);
+        dlUpdateN(dl_6_char_n, block_c, block_n[b]);
+        int32_t * window = dlWindow(dl_5_mirror_n);
+        for (int tap=0; tap<5; ++tap) {
+            pass &= (*(int32_t *) dlGetTap(dl_5_int32_n, tap) == *(int32_t *) dlGetTap(dl_5_ref, tap));
+            pass &= (window[tap] == *(int32_t *) dlGetTap(dl_5_ref, tap));
+        }
+        for (int tap=0; tap<6; ++tap) {
+            pass &= (*(char *) dlGetTap(dl_6_char_n, tap) == *(char *) dlGetTap(dl_6_char, tap));
+        }
+    }
+    pass &= (*(int32_t *) dlGetTap(dl_5_int32_n, 0) == next - 1);
+
+    /* elements that need 8 byte alignment are where the DL functions expect them */
+    for (int64_t n=1; n<=4; ++n) {
+        dlUpdate(dl_3_int64, &(int64_t) { n << 40 });
+    }
+    pass &= (dl_3_int64->element[dlGetIndex(dl_3_int64)] == (4LL << 40));
+    pass &= (*(int64_t *) dlGetTap(dl_3_int64, -1) == (2LL << 40));
+
     return ((int) !pass);
 }
 
@@ -1052,11 +2504,111 @@ int testObuf(obuf_obj_t pool) {
 }
 
 
+NEW_OBUF(obuf3, OBUF_SIZE);
+
+/* out of order frees are returned to the pool with the oldest block */
+int testObufOrder(obuf_obj_t pool) {
+  void * block[4];
+  void * ptrs[5];
+  bool  pass = true;
+
+  for (int i=0; i<4; ++i) {
+      block[i] = obufMalloc(pool, 4); pass &= (block[i] != NULL);
+  }
+  pass &= !obufFree(pool, block[3]);        // newest, out of order
+  pass &= !obufFree(pool, block[1]);
+  pass &= obufFree(pool, block[1]);         // already freed
+  obufDataPtrs(pool, ptrs, 4);
+  pass &= (ptrs[0] == block[0]) && (ptrs[1] == block[2]) && (ptrs[2] == NULL);
+  pass &= (pool->n_blks == 4);              // not returned until the oldest is freed
+
+  pass &= !obufFree(pool, block[0]);        // returns block 0 and 1
+  pass &= (pool->n_blks == 2) && (pool->oldest->data == block[2]);
+  block[0] = obufMalloc(pool, 4); pass &= (block[0] != NULL);
+  pass &= !obufFree(pool, block[2]);        // returns block 2 and 3
+  pass &= (pool->n_blks == 1) && (pool->newest->data == block[0]);
+  pass &= !obufFree(pool, block[0]);
+  pass &= (pool->n_blks == 0);
+
+  return ((int) !pass);
+}
+
+NEW_OBUF(obuf4, OBUF_SIZE);
+NEW_OBUF(obuf5, OBUF_SIZE);
+
+/* a committed block gives the unused part of its reservation back to the pool */
+int testObufCommit(obuf_obj_t pool) {
+  void * block[3];
+  bool  pass = true;
+
+  block[0] = obufReserve(pool, 48); pass &= (block[0] != NULL);
+  pass &= !obufMalloc(pool, 32);                          // reservation holds most of the pool
+  pass &= (obufCommit(pool, block[0], OBUF_SIZE) == OBUF_INVALID_POINTER);   // larger than reserved
+  pass &= (obufCommit(pool, block[0], 5) == OBUF_NOERR);
+  block[1] = obufMalloc(pool, 32); pass &= (block[1] != NULL);
+  pass &= ((char *) block[1] < (char *) block[0] + 48);  // in the returned tail
+  pass &= (obufCommit(pool, block[0], 4) == OBUF_NOERR); // no longer newest, unchanged
+  pass &= (obufCommit(pool, (char *) block[1] + 4, 4) == OBUF_INVALID_POINTER);
+  pass &= !obufFree(pool, block[0]);
+  pass &= !obufFree(pool, block[1]);
+
+  block[2] = obufReserve(pool, 40); pass &= (block[2] != NULL);
+  pass &= (obufCommit(pool, block[2], 40) == OBUF_NOERR);  // commit the entire reservation
+  pass &= !obufFree(pool, block[2]);
+  pass &= (pool->n_blks == 0);
+
+  return ((int) !pass);
+}
+
+/* SPSC blocks are consumed in order, wrap without being split, and one block's worth of free memory separates head from oldest */
+int testObufSpsc(obuf_obj_t pool) {
+  void * block[4];
+  char * data;
+  bool  pass = true;
+
+  pass &= (obufSpscOldest(pool) == NULL);
+  block[0] = obufSpscMalloc(pool, 16); pass &= (block[0] != NULL);
+  block[1] = obufSpscMalloc(pool, 16); pass &= (block[1] != NULL);
+  pass &= !obufSpscMalloc(pool, 16);        // would make head catch up with oldest
+  pass &= (obufSpscFree(pool, block[1]) == OBUF_INVALID_POINTER);  // not the oldest
+  pass &= !obufSpscFree(pool, block[0]);
+  block[2] = obufSpscMalloc(pool, 8); pass &= (block[2] != NULL);
+  pass &= !obufSpscFree(pool, block[1]);
+  pass &= !obufSpscFree(pool, block[2]);
+  pass &= (obufSpscOldest(pool) == NULL);
+  pass &= (obufSpscFree(pool, pool->buf) == OBUF_INVALID_POINTER);  // empty
+  pass &= !obufSpscFree(pool, &block);      // pointer outside of pool
+
+  for (int r=0; r<50; ++r) {                // sizes that do not divide the pool wrap at different points
+      int size = 1 + (r * 7) % 20;
+      int n = 0;
+      while ((n < 4) && (block[n] = obufSpscMalloc(pool, size))) {
+          memset(block[n], r + n, size);
+          ++n;
+      }
+      pass &= (n > 0);
+      for (int i=0; i<n; ++i) {
+          data = obufSpscOldest(pool);
+          pass &= (data == block[i]) && (data[0] == (char) (r + i)) && (data[size - 1] == (char) (r + i));
+          if (i < n - 1) {
+              pass &= (obufSpscFree(pool, block[n - 1]) == OBUF_INVALID_POINTER);  // not the oldest
+          }
+          pass &= !obufSpscFree(pool, data);
+      }
+      pass &= (obufSpscOldest(pool) == NULL);
+  }
+
+  return ((int) !pass);
+}
+
 int obuf_UNIT_TEST(void) {
   bool  fail = false;
 
   fail |= testObuf(obuf1);
   fail |= testObuf(obuf2);
+  fail |= testObufOrder(obuf3);
+  fail |= testObufCommit(obuf4);
+  fail |= testObufSpsc(obuf5);
 
   return (fail);
 }
@@ -1181,6 +2733,11 @@ int testFifoN(TFifo fifo) {
   pass &= fifoPopN(fifo, sz - 1, (uint8_t *) str);        /* pop off as chars */
   pass &= !fifoPop(fifo, &c);                             /* underflow */
 
+  fifoReset(fifo);                                        /* values survive a round trip */
+  pass &= fifoPush16(fifo, 0x1234) && fifoPop16(fifo, &hw) && (hw == 0x1234);
+  pass &= fifoPush32(fifo, 0x12345678) && fifoPop32(fifo, &w) && (w == 0x12345678);
+  pass &= fifoPush64(fifo, 0x0123456789abcdef) && fifoPop64(fifo, &ll) && (ll == 0x0123456789abcdef);
+
   fifoReset(fifo);
   pass &= fifoPush32(fifo, 0x12345678);                   /* fill fifo */
   pass &= fifoPush32(fifo, 0x12345678);
@@ -1211,6 +2768,210 @@ int testFifoN(TFifo fifo) {
   pass &= fifoPop(fifo, &c);                              /* + 1 byte  = 11 bytes */
   pass &= fifoEmpty(fifo);
 
+  for (i=0; i<sz; ++i) { str[i] = 'a' + i; }
+  for (fifo_index_t start=0; start<sz; ++start) {         /* contents survive a wrap at every position */
+      fifoReset(fifo);
+      for (i=0; i<start; ++i) { pass &= fifoPush(fifo, 0); }
+      fifoPopOff(fifo, start);
+      pass &= (fifo->tail == start) && fifoEmpty(fifo);
+      pass &= fifoPushN(fifo, sz - 1, (uint8_t *) str);
+      pass &= fifoPush(fifo, 'x');
+      pass &= fifoArray(fifo, &c, 0) && (c == 'a') && fifoArray(fifo, &c, -1) && (c == 'x');
+      pass &= fifoPopN(fifo, 3, (uint8_t *) &str[sz]);
+      pass &= !memcmp(&str[sz], str, 3);
+      pass &= !fifoPopN(fifo, sz, (uint8_t *) &str[sz]);  /* fewer than n, pops the rest */
+      pass &= !memcmp(&str[sz], &str[3], sz - 4) && (str[sz + sz - 4] == 'x');
+      pass &= fifoEmpty(fifo) && (fifo->head == fifo->tail);
+  }
+
+  return ((int) !pass);             /* return zero if all tests pass */
+}
+
+
+int testFifoSpan(TFifo fifo) {
+  fifo_index_t  n, m;
+  char *  span;
+  char  c;
+  bool  pass = true;
+
+  fifoReset(fifo);
+  span = fifoReadSpan(fifo, &n);
+  pass &= (n == 0);                                       /* empty */
+  for (fifo_index_t i=0; i<4; ++i) { pass &= fifoPush(fifo, 0); }
+  fifoPopOff(fifo, 4);                                    /* empty, head and tail at 4 */
+
+  span = fifoWriteSpan(fifo, &n);                         /* up to the end of the array */
+  pass &= (span == &fifo->element[4]) && (n == fifo->size - 4);
+  for (fifo_index_t i=0; i<n; ++i) { span[i] = 'a' + i; }
+  fifoCommitWrite(fifo, n);
+  span = fifoWriteSpan(fifo, &m);                         /* wrapped, up to tail */
+  pass &= (span == fifo->element) && (m == 4);
+  for (fifo_index_t i=0; i<m; ++i) { span[i] = 'a' + n + i; }
+  fifoCommitWrite(fifo, m);
+  pass &= fifoFull(fifo);
+  span = fifoWriteSpan(fifo, &n);
+  pass &= (n == 0);                                       /* full */
+
+  span = fifoReadSpan(fifo, &n);
+  pass &= (span == &fifo->element[4]) && (n == fifo->size - 4) && (span[0] == 'a');
+  fifoConsume(fifo, 2);
+  span = fifoReadSpan(fifo, &n);
+  pass &= (n == fifo->size - 6) && (span[0] == 'c');
+  fifoConsume(fifo, n);
+  span = fifoReadSpan(fifo, &n);
+  pass &= (span == fifo->element) && (n == 4) && (span[0] == (char) ('a' + fifo->size - 4));
+  pass &= fifoArray(fifo, &c, -1) && (c == (char) ('a' + fifo->size - 1));
+  fifoConsume(fifo, n);
+  pass &= fifoEmpty(fifo) && (fifo->tail == 4);
+
+  return ((int) !pass);             /* return zero if all tests pass */
+}
+
+
+int testFifoPopUntil(TFifo fifo) {
+  fifo_index_t  sz = fifo->size;
+  char  line[FIFO_LARGE];
+  bool  pass = true;
+
+  for (fifo_index_t start=0; start<sz; start+=7) {       /* lines and delimiters that wrap */
+      fifoReset(fifo);
+      for (fifo_index_t i=0; i<start; ++i) { pass &= fifoPush(fifo, 0); }
+      fifoPopOff(fifo, start);
+      for (fifo_index_t i=0; i<sz-1; ++i) { pass &= fifoPush(fifo, 'a' + (i % 13)); }
+      pass &= !fifoScan(fifo, '\r') && (fifoPopUntil(fifo, '\r', line, sz) == 0);
+      pass &= fifoPush(fifo, '\r');
+      pass &= fifoScan(fifo, '\r') && fifoScan(fifo, 'a' + 12) && !fifoScan(fifo, 'z');
+      pass &= (fifoPopUntil(fifo, '\r', line, sz - 1) == 0);   /* line longer than max */
+      pass &= (fifoPopUntil(fifo, 'a' + 5, line, sz) == 6) && !memcmp(line, "abcdef", 6);
+      pass &= (fifoPopUntil(fifo, '\r', line, sz) == sz - 6) && (line[sz - 7] == '\r');
+      pass &= fifoEmpty(fifo) && (fifoPopUntil(fifo, '\r', line, sz) == 0);
+  }
+
+  return ((int) !pass);             /* return zero if all tests pass */
+}
+
+
+int testFifoOver(TFifo fifo) {
+  fifo_index_t  sz = fifo->size;
+  char  c;
+  bool  pass = true;
+
+  /* This test must be run with a fifo with size == 11 */
+
+  fifoReset(fifo);
+  for (fifo_index_t i=0; i<sz+3; ++i) { fifoPushOver(fifo, 'a' + i); }  /* oldest 3 overwritten */
+  pass &= fifoFull(fifo) && (fifoOverwritten(fifo) == 3);
+  pass &= fifoPop(fifo, &c) && (c == 'd');
+  pass &= fifoArray(fifo, &c, -1) && (c == (char) ('a' + sz + 2));
+
+  pass &= fifoPopN(fifo, 5, (uint8_t *) str);            /* 5 remaining, then push 8 wrapping */
+  fifoPushNOver(fifo, 8, (uint8_t *) "01234567");
+  pass &= fifoFull(fifo) && (fifoOverwritten(fifo) == 5);
+  pass &= fifoPopN(fifo, 3, (uint8_t *) str) && !memcmp(str, "lmn", 3);
+
+  fifoPushNOver(fifo, 16, (uint8_t *) "ABCDEFGHIJKLMNOP");  /* more than the fifo holds */
+  pass &= (fifoOverwritten(fifo) == 5 + 5 + 8);
+  pass &= fifoPopN(fifo, sz, (uint8_t *) str) && !memcmp(str, "FGHIJKLMNOP", sz);
+  pass &= fifoEmpty(fifo);
+
+  fifoReset(fifo);
+  pass &= (fifoOverwritten(fifo) == 0);
+
+  return ((int) !pass);             /* return zero if all tests pass */
+}
+
+
+int testRec(TFifo fifo) {
+  fifo_index_t  sz = fifo->size;
+  fifo_index_t  n0, n1;
+  char  *p0, *p1;
+  bool  pass = true;
+
+  /* This test must be run with a fifo with size == 11 */
+
+  fifoReset(fifo);
+  pass &= !recPeek(fifo, &p0, &n0, &p1, &n1) && !recPop(fifo);  /* empty */
+  pass &= recPush(fifo, "abc", 3) && recPush(fifo, "", 0);
+  pass &= !recPush(fifo, "defg", 4);                      /* 4 + 2 bytes do not fit in 4 */
+  pass &= (fifoEntries(fifo) == 7);                       /* nothing of the failed record */
+  pass &= recPeek(fifo, &p0, &n0, &p1, &n1) && (n0 == 3) && (n1 == 0) && !memcmp(p0, "abc", 3);
+  pass &= recPop(fifo);
+  pass &= recPeek(fifo, &p0, &n0, &p1, &n1) && (n0 == 0) && (n1 == 0);
+  pass &= recPop(fifo) && fifoEmpty(fifo);
+
+  pass &= recPush(fifo, "0123456", 7);                    /* record wraps, tail at 7 */
+  pass &= recPeek(fifo, &p0, &n0, &p1, &n1) && (n0 == sz - 9) && (n1 == 7 - n0);
+  pass &= (p0 == &fifo->element[9]) && (p1 == fifo->element);
+  pass &= !memcmp(p0, "01", n0) && !memcmp(p1, "23456", n1);
+  pass &= recPop(fifo) && fifoEmpty(fifo);
+
+  pass &= recPush(fifo, "abc", 3);                        /* tail at 5, head at 10 */
+  pass &= recPush(fifo, "yz", 2) && recPush(fifo, "", 0); /* length header wraps */
+  pass &= recPop(fifo) && recPeek(fifo, &p0, &n0, &p1, &n1) && (n0 == 2) && (n1 == 0);
+  pass &= (fifo->tail == sz - 1) && (p0 == &fifo->element[1]) && !memcmp(p0, "yz", 2);
+  pass &= recPop(fifo) && recPop(fifo) && !recPop(fifo);
+
+  return ((int) !pass);             /* return zero if all tests pass */
+}
+
+
+NEW_FIFO_T(typedFifo, uint64_t, 3);
+
+int testFifoT(void) {
+  uint64_t  e;
+  bool  pass = true;
+
+  pass &= !typedFifoPop(&e);                              /* underflow */
+  for (int round=0; round<2; ++round) {                   /* second round wraps mid-fifo */
+      for (uint64_t i=0; i<3; ++i) {
+          pass &= typedFifoPush(0x0123456789abcdef + i + round);
+      }
+      pass &= !typedFifoPush(0);                          /* overflow */
+      pass &= (typedFifoEntries() == 3) && (typedFifoRemaining() == 0);
+      for (uint64_t i=0; i<3; ++i) {
+          pass &= typedFifoPop(&e) && (e == 0x0123456789abcdef + i + round);
+      }
+      pass &= !typedFifoPop(&e);
+      pass &= typedFifoPush(0) && typedFifoPop(&e);       /* offset the next round */
+  }
+  typedFifoReset();
+  pass &= (typedFifoEntries() == 0);
+
+  return ((int) !pass);             /* return zero if all tests pass */
+}
+
+
+NEW_SPSC_FIFO(spscFifo, 8);
+
+int testFifoSpsc(TSpscFifo fifo) {
+  fifo_index_t  sz = fifo->mask + 1;
+  char  c;
+  bool  pass = true;
+
+  pass &= fifoSpscEmpty(fifo) && !fifoSpscPop(fifo, &c);  /* underflow */
+  fifo->head = fifo->tail = (fifo_index_t) -4;            /* indices wrap past the index type while in use */
+  for (fifo_index_t i=0; i<sz; ++i) {
+      pass &= fifoSpscPush(fifo, 'a' + i);
+  }
+  pass &= fifoSpscFull(fifo) && !fifoSpscPush(fifo, 'z'); /* overflow */
+  pass &= (fifoSpscEntries(fifo) == sz) && (fifo->head == 4);
+  for (fifo_index_t i=0; i<sz; ++i) {
+      pass &= fifoSpscPop(fifo, &c) && (c == (char) ('a' + i));
+  }
+  pass &= fifoSpscEmpty(fifo) && !fifoSpscPop(fifo, &c);
+
+  for (fifo_index_t i=0; i<sz; ++i) { str[i] = 'A' + i; }
+  for (fifo_index_t start=0; start<sz; ++start) {         /* bulk copies wrap at every position */
+      fifo->head = fifo->tail = start;
+      pass &= fifoSpscPushN(fifo, sz - 1, (uint8_t *) str);
+      pass &= !fifoSpscPushN(fifo, 2, (uint8_t *) str);   /* all or nothing */
+      pass &= fifoSpscPush(fifo, 'x');
+      pass &= !fifoSpscPopN(fifo, sz + 1, (uint8_t *) &str[sz]);
+      pass &= fifoSpscPopN(fifo, sz, (uint8_t *) &str[sz]);
+      pass &= !memcmp(&str[sz], str, sz - 1) && (str[sz + sz - 1] == 'x');
+      pass &= fifoSpscEmpty(fifo);
+  }
+
   return ((int) !pass);             /* return zero if all tests pass */
 }
 
@@ -1222,6 +2983,12 @@ int fifo_UNIT_TEST(void) {
   fail |= testFifo(oddFifo);
   fail |= testFifo(largeFifo);
   fail |= testFifoN(oddFifo);
+  fail |= testFifoSpan(oddFifo);
+  fail |= testFifoPopUntil(largeFifo);
+  fail |= testFifoOver(oddFifo);
+  fail |= testRec(oddFifo);
+  fail |= testFifoT();
+  fail |= testFifoSpsc(spscFifo);
 
   return (fail);
 }
@@ -28,11 +28,27 @@
 #include  "contract.h"
 
 
+/*
+ * FIFO, OBUF and DL sizes and indices are 16 bits, limiting each collection
+ * to 64K. Defining MEMORY_INDEX_32 for the build makes them 32 bits, at the
+ * cost of larger control structures. Both widths share one implementation.
+ */
+#ifdef MEMORY_INDEX_32
+typedef uint32_t  mem_index_t;
+typedef int32_t   mem_sindex_t;
+#else
+typedef uint16_t  mem_index_t;
+typedef int16_t   mem_sindex_t;
+#endif
+
+#define MEM_INDEX_MAX   ((mem_index_t) -1)
+
+
 /*****************************************************************************
 
    DL: A type-independent fixed sized ring buffer delay line. Thread safe.
 
-        The number of delay line entries is limited to 64K.
+        The number of delay line entries is limited to 64K (see MEMORY_INDEX_32).
         The delay line contents are type independent - parameters must be cast to the proper type.
         The delay line is allocated at compile-time and cannot be resized or dynamically created.
         Each delay line is instantiated as an opaque object of type (void *).
@@ -45,35 +61,80 @@
         The delay line is a ring buffer with num_taps elements. New elements
         are added at tap zero and the oldest element is at tap (num_taps - 1).
         Elements may be accessed individually with dlGetTap() or as an array
-        using dlAsArray().
+        using dlAsArray(). dlUpdateN() inserts a block of elements, e.g. from
+        a DMA buffer, with the same result as a dlUpdate() of each in order.
 
         Delay line elements are type independent and function parameters
         are passed as pointers of type (void *).
 
+        A mirrored delay line, NEW_MIRRORED_DELAY_LINE, stores every element
+        twice, num_taps elements apart. dlWindow() then returns the taps in
+        order, tap zero first, as one contiguous array without rotating the
+        ring buffer, e.g. for a convolution with no wrap checks. The window
+        is valid until the next dlUpdate().
+
    Revision History:
     02/20/15  Initial release
     04/03/15  Added dlGetIndex to allow access unaffected by dlUpdate
+    10/16/26  Taps and index are mem_index_t, 32 bits with MEMORY_INDEX_32
+    10/16/26  Added mirrored delay line and dlWindow
+    10/16/26  Added dlUpdateN to insert a block of elements under one lock
+    10/16/26  Elements start 8 byte aligned, the same offset for every type
 
  *****************************************************************************/
 
+/*
+ * The generic view of a delay line used by the DL functions. The macros
+ * declare the same header, and element is 8 byte aligned in both so that it
+ * is at the same offset for every element type.
+ */
+typedef struct  {
+    const mem_index_t taps;
+    mem_index_t     index;        // always points to tap zero
+    const mem_index_t mirror;     // taps if each element is also stored at index + taps, otherwise 0
+    const size_t    type_size;
+    __attribute__ ((aligned(sizeof(uint64_t))))
+    char            element[];
+} dl_obj_t;
+
 /*
  * Macro to create a delay line ring buffer
  */
 #define NEW_DELAY_LINE(obj_name, type, num_taps)                              \
 static struct obj_name##_struct {                                             \
-    const uint16_t  taps;                                                     \
-    uint16_t        index;                                                    \
+    const mem_index_t taps;                                                   \
+    mem_index_t     index;                                                    \
+    const mem_index_t mirror;                                                 \
     const size_t    type_size;                                                \
+    __attribute__ ((aligned(sizeof(uint64_t))))                               \
     type            element[num_taps];                                        \
-}  obj_name##_obj =  { num_taps, 0, sizeof(type) };                           \
+}  obj_name##_obj =  { num_taps, 0, 0, sizeof(type) };                        \
+STATIC_ASSERT(offsetof(struct obj_name##_struct, element) == offsetof(dl_obj_t, element)); \
+struct obj_name##_struct * const obj_name = &obj_name##_obj;
+
+/*
+ * Macro to create a mirrored delay line, twice the storage of a delay line
+ */
+#define NEW_MIRRORED_DELAY_LINE(obj_name, type, num_taps)                     \
+static struct obj_name##_struct {                                             \
+    const mem_index_t taps;                                                   \
+    mem_index_t     index;                                                    \
+    const mem_index_t mirror;                                                 \
+    const size_t    type_size;                                                \
+    __attribute__ ((aligned(sizeof(uint64_t))))                               \
+    type            element[2 * (num_taps)];                                  \
+}  obj_name##_obj =  { num_taps, 0, num_taps, sizeof(type) };                 \
+STATIC_ASSERT(offsetof(struct obj_name##_struct, element) == offsetof(dl_obj_t, element)); \
 struct obj_name##_struct * const obj_name = &obj_name##_obj;
 
 
 void      dlUpdate(void * dl_obj, void * dl_element);   // insert dl_element at tap zero
-void *    dlGetTap(void * dl_obj, int16_t tap);         // return pointer to element at tap
-uint16_t  dlGetIndex(void * dl_obj);                    // return current index pointing to tap zero
+void      dlUpdateN(void * dl_obj, const void * dl_elements, mem_index_t n);  // dlUpdate each of n elements in order
+void *    dlGetTap(void * dl_obj, mem_sindex_t tap);    // return pointer to element at tap
+mem_index_t dlGetIndex(void * dl_obj);                  // return current index pointing to tap zero
 void *    dlAsArray(void * dl_obj);                     // return pointer to array of delay line elements
-uint16_t  dlTaps(void * dl_obj);                        // return number of taps in delay line
+mem_index_t dlTaps(void * dl_obj);                      // return number of taps in delay line
+void *    dlWindow(void * dl_obj);                      // mirrored only, return pointer to taps in order
 
 
 
@@ -93,11 +154,14 @@ uint16_t  dlTaps(void * dl_obj);                        // return number of taps
    'poolname' is the _obuf_obj_t object name passed to NEW_OBUF.
 
    The size of the instantiated pool is the requested size rounded up to
-   a multiple of 8 bytes plus 12 bytes of overhead.
+   a multiple of 8 bytes plus 16 bytes of overhead (24 bytes with
+   MEMORY_INDEX_32, which also lifts the 64K limit on the pool size).
 
    Blocks should be freed in the same order that they are malloc'd. Blocks
    may be freed out of order, blocks are not returned to the pool until the
-   oldest allocated block is freed.
+   oldest allocated block is freed. obufMalloc() and in-order obufFree()
+   execute in constant time. An out-of-order obufFree() searches the
+   allocated blocks to validate the pointer.
 
    If obufFree() is called with a pointer that does not lie
    within the ring buffer the call will be ignored and return with no error.
@@ -110,6 +174,19 @@ uint16_t  dlTaps(void * dl_obj);                        // return number of taps
    on the completion callback succeeds regardless of whether the string
    was in the ring buffer or non-volatile storage.
 
+   A block can be filled before its size is known, e.g. by DMA, by reserving
+   the maximum size with obufReserve() and then committing the size actually
+   used with obufCommit(). The rest of the reservation is returned to the
+   pool immediately if the block is still the newest block, otherwise the
+   block keeps its reserved size until it is freed.
+
+   A pool with a single producer, e.g. a receive ISR, and a single consumer
+   can be used without disabling interrupts through obufSpscMalloc(),
+   obufSpscOldest() and obufSpscFree(). The producer only moves the head of
+   free memory and the consumer only moves the oldest block, blocks must be
+   freed in order, and a pool must not mix these calls with the locking
+   calls. The free memory of a full SPSC pool is at least one block smaller.
+
    Useage Example:
    NEW_OBUF(ep1_out, 64);
    outstr = (char *) obufMalloc(ep1_out, 12);
@@ -119,6 +196,9 @@ uint16_t  dlTaps(void * dl_obj);                        // return number of taps
    // usbOut(outstr_const);
    assert (obufFree(ep1_out, outstr) == OBUF_NOERR);
    assert (obufFree(ep1_out, outstr_const) == OBUF_NOERR);  // allowed because outstr_const is outside of ep1_out pool
+   pkt = obufReserve(ep1_in, EP_MAX_PACKET);
+   // n = usbDMAReceive(pkt, EP_MAX_PACKET);
+   obufCommit(ep1_in, pkt, n);
 
    Revision History:
     05/01/14  Initial release
@@ -127,6 +207,10 @@ uint16_t  dlTaps(void * dl_obj);                        // return number of taps
     07/11/14  Removed restriction that blocks be freed in the order allocated, added obufMemAvail()
     07/11/14  Added obufMemAvail for diagnostics
     07/12/14  Added max_free, max_frag for diagnostics
+    10/16/26  Track newest block and flag out-of-order frees, constant time malloc and in-order free
+    10/16/26  obufReserve / obufCommit for DMA into the ring
+    10/16/26  Lock-free single-producer/single-consumer mode
+    10/16/26  Sizes and counts are mem_index_t, 32 bits with MEMORY_INDEX_32
 
  *****************************************************************************/
 
@@ -139,12 +223,13 @@ struct obuf_dblk_t {
 };
 
 typedef struct {
-    uint16_t      min_free;
-    uint16_t      n_failed;
+    mem_index_t   min_free;
+    mem_index_t   n_failed;
     p_obuf_dblk_t oldest;
-    uint16_t      n_blks;
-    uint16_t      size;
-    char          buf[1];     // rest of pool up to ~ 64K
+    p_obuf_dblk_t newest;
+    mem_index_t   n_blks;
+    mem_index_t   size;
+    char          buf[1];     // rest of pool up to ~ MEM_INDEX_MAX
 } * obuf_obj_t;
 
 /*
@@ -154,20 +239,27 @@ typedef struct {
 #define NEW_OBUF(poolname, bsize)                                              \
 __attribute__ ((aligned(sizeof(uint32_t))))                                    \
 struct {                                                                       \
-    uint16_t      max_free;                                                    \
-    uint16_t      n_failed;                                                    \
+    mem_index_t   max_free;                                                    \
+    mem_index_t   n_failed;                                                    \
     void *        oldest;                                                      \
-    uint16_t      n_blks;                                                      \
-    uint16_t      size;                                                        \
+    void *        newest;                                                      \
+    mem_index_t   n_blks;                                                      \
+    mem_index_t   size;                                                        \
     void *        buf[((bsize + 8 - 1) & ~7) / sizeof(void *)];                \
-} _obuf_obj_##poolname = { (bsize + 8 - 1) & ~7, 0, &(_obuf_obj_##poolname.buf), 0, (bsize + 8 - 1) & ~7, { &(_obuf_obj_##poolname.buf) } }; \
+} _obuf_obj_##poolname = { (bsize + 8 - 1) & ~7, 0, &(_obuf_obj_##poolname.buf), &(_obuf_obj_##poolname.buf), 0, (bsize + 8 - 1) & ~7, { &(_obuf_obj_##poolname.buf) } }; \
 obuf_obj_t const poolname = (obuf_obj_t) &_obuf_obj_##poolname
 
 void *        obufMalloc(obuf_obj_t pool, uint32_t size);   // returns NULL on error
 obuf_error_t  obufFree(obuf_obj_t pool, void * ptr);        // must free memory in the order it was malloc'd
+void *        obufReserve(obuf_obj_t pool, uint32_t max);   // returns NULL on error
+obuf_error_t  obufCommit(obuf_obj_t pool, void * ptr, uint32_t size);   // shrink a reserved block to size bytes
 void          obufDataPtrs(obuf_obj_t pool, void * ptr_array[], uint32_t n_ptrs);  // Return a list of valid data block pointers in the pool
 void          obufMemStats(obuf_obj_t pool, int * min_free, int * failed_allocs);  // return low watermark of mem avail and num of failed alloc calls
 
+void *        obufSpscMalloc(obuf_obj_t pool, uint32_t size);   // producer only, returns NULL on error
+void *        obufSpscOldest(obuf_obj_t pool);                  // consumer only, returns NULL if empty
+obuf_error_t  obufSpscFree(obuf_obj_t pool, void * ptr);        // consumer only, ptr must be the oldest block
+
 
 
 
@@ -175,7 +267,7 @@ void          obufMemStats(obuf_obj_t pool, int * min_free, int * failed_allocs)
 
    FIFO: A fifo type that operates on chars. Thread safe.
 
-        Fifo size is limited to 64K Bytes.
+        Fifo size is limited to 64K Bytes (see MEMORY_INDEX_32).
         NEW_FIFO returns a pointer to the Fifo control structure (TFifo).
         Push and Pop are optimized for time for efficiency in irq handlers.
 
@@ -196,24 +288,33 @@ void          obufMemStats(obuf_obj_t pool, int * min_free, int * failed_allocs)
     02/05/16  Added Push16/Pop16, Push32/Pop32, Push64/Pop64, PushN/PopN
     09/12/16  Separated struct TFifo from the data storage array to minimize size of initialization constant
               Changed NEW_FIFO to return a TFifo instead of an anonymous struct. This breaks the API.
+    10/16/26  PushN/PopN copy at most two contiguous segments instead of a byte at a time
+    10/16/26  Added lock-free SPSC FIFO with free-running indices
+    10/16/26  Added NEW_FIFO_T typed fifo, fixed Pop16/Pop32/Pop64 writing to their own argument
+    10/16/26  Added fifoWriteSpan, fifoReadSpan, fifoCommitWrite, fifoConsume
+    10/16/26  fifoScan searches a word at a time, added fifoPopUntil
+    10/16/26  Added overwrite-oldest fifoPushOver, fifoPushNOver and the overwritten count
+    10/16/26  Added length-prefixed records recPush, recPeek, recPop
+    10/16/26  fifo_index_t is mem_index_t, 32 bits with MEMORY_INDEX_32
 
  *****************************************************************************/
 
 
 typedef	struct	  TFifo * TFifo;
-typedef uint16_t  fifo_index_t;
+typedef mem_index_t fifo_index_t;
 
 struct TFifo {
     fifo_index_t  entries;
     fifo_index_t  size;
     fifo_index_t  head, tail;
     char *        element;
+    uint32_t      overwritten;    // chars lost to fifoPushOver / fifoPushNOver
 };
 
 /// Macro to define the storage for a FIFO. name has global scope.
-#define NEW_FIFO(name, size)                                      \
-  char name##_array[size] = { 0 };                                \
-  struct TFifo name##_struct = { 0, size, 0, 0, name##_array };   \
+#define NEW_FIFO(name, size)                                        \
+  char name##_array[size] = { 0 };                                  \
+  struct TFifo name##_struct = { 0, size, 0, 0, name##_array, 0 };  \
   const TFifo name = &name##_struct
 
 
@@ -221,99 +322,328 @@ struct TFifo {
 #define fifoEmpty(fifo)     ((bool)         (!((TFifo) fifo)->entries))
 #define fifoEntries(fifo)   ((fifo_index_t) (((TFifo) fifo)->entries))
 #define fifoRemaining(fifo) ((fifo_index_t) (((TFifo) fifo)->size - ((TFifo) fifo)->entries))
-#define fifoReset(fifo)     ((void)         (((TFifo) fifo)->entries = ((TFifo) fifo)->head = ((TFifo) fifo)->tail = 0))
+#define fifoReset(fifo)     ((void)         (((TFifo) fifo)->entries = ((TFifo) fifo)->head = ((TFifo) fifo)->tail = 0, ((TFifo) fifo)->overwritten = 0))
+#define fifoOverwritten(fifo) ((uint32_t)     (((TFifo) fifo)->overwritten))
 
 void  fifoFill(TFifo fifo, char c);		  	                /* fill fifo with c */
 bool  fifoScan(TFifo fifo, char c);     	                /* returns TRUE if c is in fifo */
+fifo_index_t fifoPopUntil(TFifo fifo, char delim, char * buf, fifo_index_t max);  /* pop up to and including delim if within max chars */
+                                                          /* returns the number popped, 0 and nothing popped if no delim */
 bool  fifoPush(TFifo fifo, char c);                       /* returns FALSE if fifo full */
 bool  fifoPush16(TFifo fifo, uint16_t hw);
 bool  fifoPush32(TFifo fifo, uint32_t w);
 bool  fifoPush64(TFifo fifo, uint64_t ll);
-bool  fifoPushN(TFifo fifo, uint16_t n, uint8_t * array);
+bool  fifoPushN(TFifo fifo, fifo_index_t n, uint8_t * array);
 bool  fifoPushStr(TFifo fifo, char * str);                /* returns false if fifo cannot contain entire string */
+void  fifoPushOver(TFifo fifo, char c);                   /* if full, overwrite the oldest char and count it */
+void  fifoPushNOver(TFifo fifo, fifo_index_t n, uint8_t * array); /* if n > remaining, overwrite the oldest chars and count them */
 bool  fifoPop(TFifo fifo, char * c);     	                /* return FALSE if fifo empty */
 bool  fifoPop16(TFifo fifo, uint16_t * hw);
 bool  fifoPop32(TFifo fifo, uint32_t * w);
 bool  fifoPop64(TFifo fifo, uint64_t * ll);
-bool  fifoPopN(TFifo fifo, uint16_t n, uint8_t * array);
-bool  fifoPopStr(TFifo fifo, char * str, uint16_t n);     /* pop n items into str, terminate with '\0', n may be > fifo.size */
+bool  fifoPopN(TFifo fifo, fifo_index_t n, uint8_t * array);
+bool  fifoPopStr(TFifo fifo, char * str, fifo_index_t n);     /* pop n items into str, terminate with '\0', n may be > fifo.size */
 void  fifoPopOff(TFifo fifo, fifo_index_t n);	            /* pop n items off and discard them, n may be > fifo.size */
 bool  fifoArray(TFifo fifo, char *c, int32_t i);          /* treat the fifo like an array and return element [i] */
                                                           /* i may be negative where -1 is the end of the fifo */
 												                                  /* return false if i is out of range */
 
+/*
+ * Spans give direct access to fifo storage, e.g. for DMA or a bulk write. A
+ * span is the largest contiguous region that can be written at head or read
+ * at tail, so a wrapped fifo takes two spans. Data written to a write span is
+ * pushed by fifoCommitWrite() and data read from a read span is popped by
+ * fifoConsume(). A span remains valid while the other side of the fifo is in
+ * use, but only one writer and one reader may use spans at a time.
+ */
+char *  fifoWriteSpan(TFifo fifo, fifo_index_t * n);      /* n is set to the length of the span, 0 if full */
+char *  fifoReadSpan(TFifo fifo, fifo_index_t * n);       /* n is set to the length of the span, 0 if empty */
+void    fifoCommitWrite(TFifo fifo, fifo_index_t n);      /* push n bytes written to the write span */
+void    fifoConsume(TFifo fifo, fifo_index_t n);          /* pop n bytes read from the read span */
+
+/*
+ * Records are variable length messages stored in a TFifo, each preceded by a
+ * two byte length. A record is pushed entirely or not at all, and is read in
+ * place with recPeek(), which returns one span or two if the record wraps,
+ * before recPop() discards it. A fifo used for records must not be used
+ * with the byte push and pop calls. A record needs len + 2 bytes of fifo and
+ * is at most 64K - 1 bytes long.
+ */
+bool  recPush(TFifo fifo, const void * ptr, fifo_index_t len);  /* returns FALSE if the record does not fit */
+bool  recPeek(TFifo fifo, char ** p0, fifo_index_t * n0, char ** p1, fifo_index_t * n1);  /* returns FALSE if empty */
+bool  recPop(TFifo fifo);                                 /* discard the next record, returns FALSE if empty */
+
+
+/*
+ * Typed FIFO: NEW_FIFO_T generates a fifo of any element type with inline
+ * functions specialized for that type, so elements are copied whole rather
+ * than through the byte fifo. The fifo and its functions have file scope.
+ *
+ *      NEW_FIFO_T(adcQueue, uint16_t, 32);
+ *      adcQueuePush(sample);               // returns false if full
+ *      while (adcQueuePop(&sample))        // returns false if empty
+ */
+#define NEW_FIFO_T(name, type, size)                                                \
+static type name##_array[size];                                                     \
+static struct { fifo_index_t entries, head, tail; } name##_struct;                  \
+static inline bool name##Push(type e) {                                             \
+    bool success = false;                                                           \
+    LOCK;                                                                           \
+    if (name##_struct.entries < (size)) {                                           \
+        name##_array[name##_struct.head] = e;                                       \
+        if (++name##_struct.head == (size)) { name##_struct.head = 0; }             \
+        ++name##_struct.entries;                                                    \
+        success = true;                                                             \
+    }                                                                               \
+    END_LOCK;                                                                       \
+    return (success);                                                               \
+}                                                                                   \
+static inline bool name##Pop(type * e) {                                            \
+    bool success = false;                                                           \
+    LOCK;                                                                           \
+    if (name##_struct.entries) {                                                    \
+        *e = name##_array[name##_struct.tail];                                      \
+        if (++name##_struct.tail == (size)) { name##_struct.tail = 0; }             \
+        --name##_struct.entries;                                                    \
+        success = true;                                                             \
+    }                                                                               \
+    END_LOCK;                                                                       \
+    return (success);                                                               \
+}                                                                                   \
+static inline fifo_index_t name##Entries(void)   { return (name##_struct.entries); }           \
+static inline fifo_index_t name##Remaining(void) { return ((size) - name##_struct.entries); }  \
+static inline void         name##Reset(void)     { LOCK; name##_struct.entries = name##_struct.head = name##_struct.tail = 0; END_LOCK; } \
+STATIC_ASSERT(((size) > 0) && ((size) <= MEM_INDEX_MAX))
+
+
+/*
+ * SPSC FIFO: A lock-free fifo for a single producer and a single consumer,
+ * e.g. an irq handler and a task. The size must be a power of two. head and
+ * tail run freely and are masked to index the element array, so there is no
+ * shared entries counter. Only the producer writes head and only the
+ * consumer writes tail, so neither side disables interrupts.
+ *
+ *      NEW_SPSC_FIFO(rxQueue, 64);
+ *      fifoSpscPush(rxQueue, c);           // irq handler
+ *      while (fifoSpscPop(rxQueue, &c))    // task
+ */
+typedef	struct	  TSpscFifo * TSpscFifo;
+
+struct TSpscFifo {
+    fifo_index_t volatile head;     // written by the producer only
+    fifo_index_t volatile tail;     // written by the consumer only
+    fifo_index_t          mask;     // size - 1
+    char *                element;
+};
+
+/// Macro to define the storage for a SPSC FIFO. name has global scope. size must be a power of two <= half the index range.
+#define NEW_SPSC_FIFO(name, size)                                                       \
+  STATIC_ASSERT(((size) > 0) && ((size) <= (MEM_INDEX_MAX / 2 + 1)) && (((size) & ((size) - 1)) == 0)); \
+  char name##_array[size] = { 0 };                                                      \
+  struct TSpscFifo name##_struct = { 0, 0, (size) - 1, name##_array };                  \
+  const TSpscFifo name = &name##_struct
+
+#define fifoSpscEntries(fifo)   ((fifo_index_t) (((TSpscFifo) fifo)->head - ((TSpscFifo) fifo)->tail))
+#define fifoSpscRemaining(fifo) ((fifo_index_t) (((TSpscFifo) fifo)->mask + 1 - fifoSpscEntries(fifo)))
+#define fifoSpscEmpty(fifo)     ((bool)         (fifoSpscEntries(fifo) == 0))
+#define fifoSpscFull(fifo)      ((bool)         (fifoSpscRemaining(fifo) == 0))
+
+bool  fifoSpscPush(TSpscFifo fifo, char c);               /* producer only, returns FALSE if fifo full */
+bool  fifoSpscPushN(TSpscFifo fifo, fifo_index_t n, uint8_t * array);   /* producer only, all or nothing */
+bool  fifoSpscPop(TSpscFifo fifo, char * c);              /* consumer only, returns FALSE if fifo empty */
+bool  fifoSpscPopN(TSpscFifo fifo, fifo_index_t n, uint8_t * array);    /* consumer only, all or nothing */
+
 
 
 /*****************************************************************************
 
    POOL: A thread-safe malloc alternative that allocates fixed sized blocks.
 
-       The total number of blocks is limited to 64.
+       The number of blocks in each partition is limited to 1024.
        The maximum allocation block size is 1024 bytes.
-       The number and size of allocation blocks are optimized to each application
-           using the #define POOL_PARTITION_xx_BLOCKS macros.
+       The block size of each partition is a size class set at compile time
+           with the #define POOL_CLASS_n macros, powers of two by default.
+       Each pool is allocated at compile-time with NEW_POOL and has its own
+           partition layout, allocation bitmap, statistics and history.
+       The default pool used by poolMalloc / poolFree is sized using the
+           #define POOL_PARTITION_xx_BLOCKS macros.
 
        Definitions:
            POOL - the entire statically allocated memory area, including overhead.
-           PARTITION - A subset of the pool containing equally sized blocks in
-                       power-of-two increments.
-           BLOCK - A single power-of-two sized allocatable section of a partition
+           PARTITION - A subset of the pool containing equally sized blocks of
+                       one size class.
+           BLOCK - A single class sized allocatable section of a partition
 
-        A call to poolMalloc(size) will attempt to allocate the smallest power-of-two
+        A call to poolMalloc(size) will attempt to allocate the smallest class
         block available that will hold size bytes. In the pathological case an attempt
         to allocate 1 byte may use a 1024 byte block.
 
+        poolMalloc() and poolFree() execute in constant time regardless of the
+        number of blocks in the pool. They are lockless and safe to call from
+        interrupt handlers: blocks are claimed with a compare-and-swap on the
+        allocation bitmap (cpuCAS), and statistics and history are updated
+        the same way.
+
+        poolRealloc(ptr, size) returns ptr unchanged when its block is the best
+        fit for size. A block that is too small is moved to a larger block and
+        its contents copied. A block that is larger than the best fit is moved
+        to a smaller block if one is free, or split in place in a buddy pool,
+        so that the larger block is released. realloc(NULL, size) is malloc
+        and realloc(ptr, 0) is free.
+
+        The partition spec is the number of blocks in the 8, 16, 32, 64, 128,
+        256, 512 and 1024 byte partitions, and may be given as a macro.
+
+        Buddy mode
+        A pool created with NEW_BUDDY_POOL splits a larger free block into two
+        halves when the best fit partition is exhausted, and merges the halves
+        back into the larger block when both are free. A 1 byte request from
+        a pool of 1024 byte blocks then uses an 8 byte half of a half ... of
+        a block instead of the whole block. Split and free-half state is kept
+        in a bit vector per block size, and the number of splits and merges
+        is reported in the pool statistics. Buddy pools serialize malloc and
+        free with a short LOCK, and the free-half search is proportional to
+        the number of words in a bit vector rather than constant time.
+
+        Usage Example:
+        #define USB_POOL_SPEC   0, 0, 0, 8, 0, 0, 0, 2
+        NEW_POOL(usb_pool, USB_POOL_SPEC);
+        NEW_POOL(log_pool, 32, 16, 0, 0, 0, 0, 0, 0);
+        NEW_BUDDY_POOL(msg_pool, 0, 0, 0, 0, 0, 0, 0, 4);
+        pkt = poolMallocFrom(usb_pool, 520);
+        poolFreeTo(usb_pool, pkt);
+
    Revision History:
     09/09/16  Initial release
+    10/16/26  Two-level allocation bitmap, up to 1024 blocks per partition
+    10/16/26  Instance pools with NEW_POOL, poolMallocFrom, poolFreeTo, poolProfileOf
+    10/16/26  Lockless malloc/free, history is a ring of the most recent operations
+    10/16/26  Buddy split/coalesce pools with NEW_BUDDY_POOL
+    10/16/26  Configurable size classes, wasted bytes per class in the statistics
+    10/16/26  poolDumpOf / poolDump text dump for the pool sizing tool
+    10/16/26  Requested bytes per partition, malloc/free cycle timing with POOL_TIMING
+    10/16/26  poolRealloc / poolReallocFrom
+    10/16/26  Timing min starts at UINT32_MAX, SysTick of any reload, DWT enabled on first use
 
  *****************************************************************************/
 
 /*
  * Constants fixed by implementation. Do not change.
  */
-#define POOL_BLOCKS_MAX               64
 #define POOL_PARTITIONS               8
+#define POOL_PARTITION_BLOCKS_MAX     1024    // 32 allocation words of 32 blocks
+#define POOL_BLOCKS_MAX               (POOL_PARTITIONS * POOL_PARTITION_BLOCKS_MAX)
 
 /*
- * There are 8 partitions of 8, 16, 32, 64, 128, 256, 512, and 1024 bytes.
- * The number is blocks in each partition is application dependent and
- * set by the macros below.
+ * Size class (block size in bytes) of each partition. The defaults are the
+ * powers of two 8, 16, 32, 64, 128, 256, 512 and 1024. They may be overridden
+ * on the command line with any strictly increasing multiples of 4 up to 1024
+ * to fit the objects an application allocates, e.g. 8, 12, 20, 32, 64, 128,
+ * 520, 1024. Blocks are aligned to 4 bytes, or 8 if every class is a multiple
+ * of 8. Buddy pools require the default classes.
+ */
+#ifndef POOL_CLASS_0
+#define POOL_CLASS_0                  8
+#endif
+#ifndef POOL_CLASS_1
+#define POOL_CLASS_1                  16
+#endif
+#ifndef POOL_CLASS_2
+#define POOL_CLASS_2                  32
+#endif
+#ifndef POOL_CLASS_3
+#define POOL_CLASS_3                  64
+#endif
+#ifndef POOL_CLASS_4
+#define POOL_CLASS_4                  128
+#endif
+#ifndef POOL_CLASS_5
+#define POOL_CLASS_5                  256
+#endif
+#ifndef POOL_CLASS_6
+#define POOL_CLASS_6                  512
+#endif
+#ifndef POOL_CLASS_7
+#define POOL_CLASS_7                  1024
+#endif
+
+#define POOL_CLASSES_POW2   ((POOL_CLASS_0 == 8)   && (POOL_CLASS_1 == 16)  && (POOL_CLASS_2 == 32)  && (POOL_CLASS_3 == 64) &&  \
+                             (POOL_CLASS_4 == 128) && (POOL_CLASS_5 == 256) && (POOL_CLASS_6 == 512) && (POOL_CLASS_7 == 1024))
+
+/*
+ * There are 8 partitions, one of each size class. They are named by their
+ * default class: POOL_PARTITION_8_BLOCKS is the number of blocks of class 0.
+ * The number is blocks in each partition of the default pool is application
+ * dependent and set by the macros below. They may be overridden on the
+ * command line.
  *
- * Total RAM statically allocated for the pool is the sum of the blocks
- * in each partition, plus overhead.
+ * Total RAM statically allocated for a pool is the sum of the blocks
+ * in each partition, plus overhead of one bit per block rounded up to
+ * a 32 bit word per partition.
  */
+#ifndef POOL_PARTITION_8_BLOCKS
 #define POOL_PARTITION_8_BLOCKS       16      // number of 8 byte blocks
+#endif
+#ifndef POOL_PARTITION_16_BLOCKS
 #define POOL_PARTITION_16_BLOCKS      8
+#endif
+#ifndef POOL_PARTITION_32_BLOCKS
 #define POOL_PARTITION_32_BLOCKS      4
+#endif
+#ifndef POOL_PARTITION_64_BLOCKS
 #define POOL_PARTITION_64_BLOCKS      2
+#endif
+#ifndef POOL_PARTITION_128_BLOCKS
 #define POOL_PARTITION_128_BLOCKS     2
+#endif
+#ifndef POOL_PARTITION_256_BLOCKS
 #define POOL_PARTITION_256_BLOCKS     1
+#endif
+#ifndef POOL_PARTITION_512_BLOCKS
 #define POOL_PARTITION_512_BLOCKS     0
+#endif
+#ifndef POOL_PARTITION_1024_BLOCKS
 #define POOL_PARTITION_1024_BLOCKS    0
+#endif
+
+#define POOL_PARTITION_SPEC   POOL_PARTITION_8_BLOCKS,   POOL_PARTITION_16_BLOCKS,  POOL_PARTITION_32_BLOCKS,  POOL_PARTITION_64_BLOCKS,    \
+                              POOL_PARTITION_128_BLOCKS, POOL_PARTITION_256_BLOCKS, POOL_PARTITION_512_BLOCKS, POOL_PARTITION_1024_BLOCKS
 
-/* Total up number of blocks and verify it is <= allowable max of 64 */
+/* Total up number of blocks in the default pool */
 #define POOL_BLOCKS   (POOL_PARTITION_8_BLOCKS   + POOL_PARTITION_16_BLOCKS  +    \
                        POOL_PARTITION_32_BLOCKS  + POOL_PARTITION_64_BLOCKS  +    \
                        POOL_PARTITION_128_BLOCKS + POOL_PARTITION_256_BLOCKS +    \
                        POOL_PARTITION_512_BLOCKS + POOL_PARTITION_1024_BLOCKS)
 
-#if (POOL_BLOCKS > POOL_BLOCKS_MAX)
-#error ("No more than 64 blocks can be defined in the memory pool.")
-#endif
-
 /*
  * Profiling / Statistics support
  *
- * pool_stat is a record of allocation attemts/failures for each partition
+ * pool_stat is a record of allocation attemts/failures for each partition,
+ * the number of blocks allocated at one time and its high water mark, and
+ * the bytes requested from the partition and the bytes allocated in excess
+ * of the request (waste). The bytes allocated are requested + waste.
+ *
+ * pool_timing is the minimum, maximum and total time in cycles of poolMalloc
+ * [POOL_TIMING_MALLOC] and poolFree [POOL_TIMING_FREE], and the number of
+ * calls timed. The average is total / cnt. Timing is recorded only if
+ * POOL_TIMING is defined. The cycles are read from the DWT cycle counter on
+ * M3/M4, which the first timed call enables, or from SysTick on M0/M0+, which
+ * must be clocked by the core and may keep any reload, such as a 1 ms tick,
+ * longer than an operation. Time in interrupt handlers that run during an
+ * operation is included. min is UINT32_MAX until a call is timed. total and
+ * cnt wrap.
  *
- * pool_state is the bit vector maintaining the allocated/free state of each block.
- * The organization of the bit vector is dependent upon the number of blocks
- * in each partition. Bit 0 of the bit vector corresponds to the first block
- * of the smallest defined partition.
+ * pool_state is the array of 32 bit allocation words maintaining the
+ * allocated (1) / free (0) state of each block. Each partition starts on a
+ * new word, beginning with the smallest defined partition. Bit 0 of the
+ * first word of a partition corresponds to the first block of the partition.
  *
- * pool_history is a fifo containing a record of the last POOL_HISTORY_DEPTH
+ * pool_history is a ring containing a record of the last POOL_HISTORY_DEPTH
  * memory operations (poolMalloc, poolFree). size is the block size allocated
- * or freed and may differ from size requested by poolMalloc.
+ * or freed and may differ from size requested by poolMalloc. The history is
+ * only allocated and recorded if PROFILE is defined, otherwise it is NULL.
+ * pool_history_cnt is the number of operations ever recorded, the most recent
+ * is at pool_history[(pool_history_cnt - 1) % POOL_HISTORY_DEPTH].
  * Each entry is 16 bits of the form:
  *
  *       15   14                        0
@@ -324,24 +654,222 @@ bool  fifoArray(TFifo fifo, char *c, int32_t i);          /* treat the fifo like
  *     OP = 1 for poolMalloc, 0 for poolFree
  *
  */
-#define POOL_HISTORY_DEPTH            1024      // entries in pool history
+#ifndef POOL_HISTORY_DEPTH
+#define POOL_HISTORY_DEPTH            1024      // entries in pool history, must be a power of two
+#endif
 
+/* Counters are paired in 32 bit words so that each pair is updated with a single CAS */
 typedef struct {
-    uint8_t   cur_alloc;    // number of blocks currently allocated
-    uint8_t   max_alloc;    // maximum number of blocks allocated at one time
+    uint16_t  cur_alloc;    // number of blocks currently allocated
+    uint16_t  max_alloc;    // maximum number of blocks allocated at one time
     uint16_t  cnt_alloc;    // number of times a block has been allocated from this partition
     uint16_t  cnt_fail;     // number of times no blocks were available for allocation from this partition
-} pool_stats_t;
+    uint16_t  cnt_split;    // number of times a block of this size was split into two halves (buddy pools)
+    uint16_t  cnt_merge;    // number of times two halves were merged into a block of this size (buddy pools)
+    uint32_t  waste;        // bytes allocated from this partition in excess of the size requested
+    uint32_t  requested;    // bytes requested that were allocated from this partition
+} __attribute__ ((aligned(sizeof(uint32_t)))) pool_stats_t;
+
+#define POOL_TIMING_MALLOC            0
+#define POOL_TIMING_FREE              1
+
+typedef struct {
+    uint32_t  min;          // cycles of the fastest call, UINT32_MAX if none timed
+    uint32_t  max;          // cycles of the slowest call
+    uint32_t  total;        // cycles of all calls timed
+    uint32_t  cnt;          // number of calls timed
+} pool_timing_t;
+
+#define POOL_TIMING_INIT              { UINT32_MAX, 0, 0, 0 }
 
 typedef struct {
     volatile pool_stats_t * pool_stat;
-    TFifo                   pool_history;
-    volatile uint64_t *     pool_state;
+    volatile uint16_t *     pool_history;
+    volatile uint32_t *     pool_history_cnt;
+    volatile uint32_t *     pool_state;
+    volatile pool_timing_t * pool_timing;               // [POOL_TIMING_MALLOC], [POOL_TIMING_FREE]
 } pool_profile_t;
 
+/*
+ * Partition layout of a pool, computed at compile time and kept in flash.
+ * Partitions are laid out in the pool storage from largest (1024) at offset
+ * zero to smallest (8) so that with the default classes every block is
+ * naturally aligned to its own size.
+ * Allocation words are assigned to partitions from smallest to largest.
+ */
+typedef struct {
+    uint16_t  blocks[POOL_PARTITIONS];    // number of blocks in each partition
+    uint16_t  word[POOL_PARTITIONS];      // index of first allocation word of each partition
+    uint32_t  offset[POOL_PARTITIONS];    // byte offset of each partition in the pool storage
+    uint32_t  size;                       // bytes of pool storage
+} pool_geometry_t;
+
+typedef struct pool_t * pool_obj_t;
+struct pool_t {
+    const pool_geometry_t * geometry;
+    char *                  mem;                      // block storage
+    uint32_t volatile *     leaf;                     // allocation words, 1 if block allocated
+    uint32_t *              buddy;                    // split and free-half bit vectors, NULL if not a buddy pool
+    uint32_t volatile       summary[POOL_PARTITIONS]; // 1 if allocation word full
+    uint32_t volatile       full;                     // 1 if partition full
+    pool_stats_t            stat[POOL_PARTITIONS];
+    uint16_t *              history;                  // ring of POOL_HISTORY_DEPTH entries
+    uint32_t volatile       history_cnt;              // operations recorded
+    pool_profile_t          profile;
+    pool_timing_t           timing[2];                // malloc and free cycles
+};
+
+/*
+ * Helper macros to compute the pool geometry from a partition spec.
+ */
+#define POOL_WORDS(blocks)      (((blocks) + 31) / 32)
+
+#define POOL_SPEC_OFFSET_1024(n8, n16, n32, n64, n128, n256, n512, n1024)  0
+#define POOL_SPEC_OFFSET_512(n8, n16, n32, n64, n128, n256, n512, n1024)   (POOL_CLASS_7 * (n1024))
+#define POOL_SPEC_OFFSET_256(n8, n16, n32, n64, n128, n256, n512, n1024)   (POOL_SPEC_OFFSET_512(n8, n16, n32, n64, n128, n256, n512, n1024) + (POOL_CLASS_6 * (n512)))
+#define POOL_SPEC_OFFSET_128(n8, n16, n32, n64, n128, n256, n512, n1024)   (POOL_SPEC_OFFSET_256(n8, n16, n32, n64, n128, n256, n512, n1024) + (POOL_CLASS_5 * (n256)))
+#define POOL_SPEC_OFFSET_64(n8, n16, n32, n64, n128, n256, n512, n1024)    (POOL_SPEC_OFFSET_128(n8, n16, n32, n64, n128, n256, n512, n1024) + (POOL_CLASS_4 * (n128)))
+#define POOL_SPEC_OFFSET_32(n8, n16, n32, n64, n128, n256, n512, n1024)    (POOL_SPEC_OFFSET_64(n8, n16, n32, n64, n128, n256, n512, n1024)  + (POOL_CLASS_3 * (n64)))
+#define POOL_SPEC_OFFSET_16(n8, n16, n32, n64, n128, n256, n512, n1024)    (POOL_SPEC_OFFSET_32(n8, n16, n32, n64, n128, n256, n512, n1024)  + (POOL_CLASS_2 * (n32)))
+#define POOL_SPEC_OFFSET_8(n8, n16, n32, n64, n128, n256, n512, n1024)     (POOL_SPEC_OFFSET_16(n8, n16, n32, n64, n128, n256, n512, n1024)  + (POOL_CLASS_1 * (n16)))
+#define POOL_SPEC_SIZE(n8, n16, n32, n64, n128, n256, n512, n1024)         (POOL_SPEC_OFFSET_8(n8, n16, n32, n64, n128, n256, n512, n1024)   + (POOL_CLASS_0 * (n8)))
+
+#define POOL_SPEC_WORD_8(n8, n16, n32, n64, n128, n256, n512, n1024)       0
+#define POOL_SPEC_WORD_16(n8, n16, n32, n64, n128, n256, n512, n1024)      (POOL_WORDS(n8))
+#define POOL_SPEC_WORD_32(n8, n16, n32, n64, n128, n256, n512, n1024)      (POOL_SPEC_WORD_16(n8, n16, n32, n64, n128, n256, n512, n1024)  + POOL_WORDS(n16))
+#define POOL_SPEC_WORD_64(n8, n16, n32, n64, n128, n256, n512, n1024)      (POOL_SPEC_WORD_32(n8, n16, n32, n64, n128, n256, n512, n1024)  + POOL_WORDS(n32))
+#define POOL_SPEC_WORD_128(n8, n16, n32, n64, n128, n256, n512, n1024)     (POOL_SPEC_WORD_64(n8, n16, n32, n64, n128, n256, n512, n1024)  + POOL_WORDS(n64))
+#define POOL_SPEC_WORD_256(n8, n16, n32, n64, n128, n256, n512, n1024)     (POOL_SPEC_WORD_128(n8, n16, n32, n64, n128, n256, n512, n1024) + POOL_WORDS(n128))
+#define POOL_SPEC_WORD_512(n8, n16, n32, n64, n128, n256, n512, n1024)     (POOL_SPEC_WORD_256(n8, n16, n32, n64, n128, n256, n512, n1024) + POOL_WORDS(n256))
+#define POOL_SPEC_WORD_1024(n8, n16, n32, n64, n128, n256, n512, n1024)    (POOL_SPEC_WORD_512(n8, n16, n32, n64, n128, n256, n512, n1024) + POOL_WORDS(n512))
+#define POOL_SPEC_WORDS(n8, n16, n32, n64, n128, n256, n512, n1024)        (POOL_SPEC_WORD_1024(n8, n16, n32, n64, n128, n256, n512, n1024) + POOL_WORDS(n1024))
+
+/* Partitions with no blocks are permanently full */
+#define POOL_SPEC_EMPTY(n8, n16, n32, n64, n128, n256, n512, n1024)                     \
+    ((!(n8)      << 0) | (!(n16)  << 1) | (!(n32)  << 2) | (!(n64)   << 3) |            \
+     (!(n128)    << 4) | (!(n256) << 5) | (!(n512) << 6) | (!(n1024) << 7))
+
+#define POOL_SPEC_TOO_LARGE(n8, n16, n32, n64, n128, n256, n512, n1024)                 \
+    (((n8)   > POOL_PARTITION_BLOCKS_MAX) || ((n16)  > POOL_PARTITION_BLOCKS_MAX) ||    \
+     ((n32)  > POOL_PARTITION_BLOCKS_MAX) || ((n64)  > POOL_PARTITION_BLOCKS_MAX) ||    \
+     ((n128) > POOL_PARTITION_BLOCKS_MAX) || ((n256) > POOL_PARTITION_BLOCKS_MAX) ||    \
+     ((n512) > POOL_PARTITION_BLOCKS_MAX) || ((n1024) > POOL_PARTITION_BLOCKS_MAX))
+
+/*
+ * A buddy pool keeps two bit vectors for each block size, one bit per block
+ * of that size in the part of the pool storage where it can occur. Halves of
+ * size s only occur in the partitions larger than s, which are laid out
+ * below the offset of partition s. A split s block is either one of those
+ * halves or a native block of partition s.
+ *
+ *     half[s]    bit set if the block of size s is a free half of a split block
+ *     split[s]   bit set if the block of size s is split into two halves
+ *
+ * The vectors are stored in order of block size, half[8], split[8], half[16] ...
+ * followed by a spare word so that the array is never empty.
+ */
+#define POOL_BUDDY_WORDS(n8, n16, n32, n64, n128, n256, n512, n1024)                                     \
+    (POOL_WORDS(POOL_SPEC_OFFSET_8(n8, n16, n32, n64, n128, n256, n512, n1024)   >> 3) +               \
+     POOL_WORDS(POOL_SPEC_OFFSET_16(n8, n16, n32, n64, n128, n256, n512, n1024)  >> 4) +               \
+     POOL_WORDS(POOL_SPEC_OFFSET_32(n8, n16, n32, n64, n128, n256, n512, n1024)  >> 5) +               \
+     POOL_WORDS(POOL_SPEC_OFFSET_64(n8, n16, n32, n64, n128, n256, n512, n1024)  >> 6) +               \
+     POOL_WORDS(POOL_SPEC_OFFSET_128(n8, n16, n32, n64, n128, n256, n512, n1024) >> 7) +               \
+     POOL_WORDS(POOL_SPEC_OFFSET_256(n8, n16, n32, n64, n128, n256, n512, n1024) >> 8) +               \
+     POOL_WORDS(POOL_SPEC_OFFSET_512(n8, n16, n32, n64, n128, n256, n512, n1024) >> 9) +   /* half */  \
+     POOL_WORDS(POOL_SPEC_OFFSET_8(n8, n16, n32, n64, n128, n256, n512, n1024)   >> 4) +               \
+     POOL_WORDS(POOL_SPEC_OFFSET_16(n8, n16, n32, n64, n128, n256, n512, n1024)  >> 5) +               \
+     POOL_WORDS(POOL_SPEC_OFFSET_32(n8, n16, n32, n64, n128, n256, n512, n1024)  >> 6) +               \
+     POOL_WORDS(POOL_SPEC_OFFSET_64(n8, n16, n32, n64, n128, n256, n512, n1024)  >> 7) +               \
+     POOL_WORDS(POOL_SPEC_OFFSET_128(n8, n16, n32, n64, n128, n256, n512, n1024) >> 8) +               \
+     POOL_WORDS(POOL_SPEC_OFFSET_256(n8, n16, n32, n64, n128, n256, n512, n1024) >> 9) +               \
+     POOL_WORDS(POOL_SPEC_OFFSET_512(n8, n16, n32, n64, n128, n256, n512, n1024) >> 10) + 1) /* split */
+
+#define POOL_BUDDY_NONE(name, n8, n16, n32, n64, n128, n256, n512, n1024)
+#define POOL_BUDDY_PTR_NONE(name)   NULL
+#define POOL_BUDDY_BUDDY(name, n8, n16, n32, n64, n128, n256, n512, n1024)                                    \
+    STATIC_ASSERT(POOL_CLASSES_POW2);   /* buddies are halves */                                                 \
+    static uint32_t _pool_buddy_##name[POOL_BUDDY_WORDS(n8, n16, n32, n64, n128, n256, n512, n1024)];
+#define POOL_BUDDY_PTR_BUDDY(name)  (_pool_buddy_##name)
+
+#ifdef PROFILE
+#define POOL_HISTORY(name)      static uint16_t _pool_history_##name[POOL_HISTORY_DEPTH];
+#define POOL_HISTORY_PTR(name)  (_pool_history_##name)
+#else
+#define POOL_HISTORY(name)
+#define POOL_HISTORY_PTR(name)  NULL
+#endif
+
+/*
+ * Macro to create a memory pool. The partition spec may be a macro that
+ * expands to the eight partition block counts.
+ */
+#define NEW_POOL(name, ...)         _NEW_POOL(NONE, name, __VA_ARGS__)
+#define NEW_BUDDY_POOL(name, ...)   _NEW_POOL(BUDDY, name, __VA_ARGS__)
+
+#define _NEW_POOL(mode, name, n8, n16, n32, n64, n128, n256, n512, n1024)                                           \
+STATIC_ASSERT(!POOL_SPEC_TOO_LARGE(n8, n16, n32, n64, n128, n256, n512, n1024));  /* max 1024 blocks per partition */ \
+static const pool_geometry_t _pool_geometry_##name = {                                                        \
+    { n8, n16, n32, n64, n128, n256, n512, n1024 },                                                           \
+    { POOL_SPEC_WORD_8(n8, n16, n32, n64, n128, n256, n512, n1024),                                           \
+      POOL_SPEC_WORD_16(n8, n16, n32, n64, n128, n256, n512, n1024),                                          \
+      POOL_SPEC_WORD_32(n8, n16, n32, n64, n128, n256, n512, n1024),                                          \
+      POOL_SPEC_WORD_64(n8, n16, n32, n64, n128, n256, n512, n1024),                                          \
+      POOL_SPEC_WORD_128(n8, n16, n32, n64, n128, n256, n512, n1024),                                         \
+      POOL_SPEC_WORD_256(n8, n16, n32, n64, n128, n256, n512, n1024),                                         \
+      POOL_SPEC_WORD_512(n8, n16, n32, n64, n128, n256, n512, n1024),                                         \
+      POOL_SPEC_WORD_1024(n8, n16, n32, n64, n128, n256, n512, n1024) },                                      \
+    { POOL_SPEC_OFFSET_8(n8, n16, n32, n64, n128, n256, n512, n1024),                                         \
+      POOL_SPEC_OFFSET_16(n8, n16, n32, n64, n128, n256, n512, n1024),                                        \
+      POOL_SPEC_OFFSET_32(n8, n16, n32, n64, n128, n256, n512, n1024),                                        \
+      POOL_SPEC_OFFSET_64(n8, n16, n32, n64, n128, n256, n512, n1024),                                        \
+      POOL_SPEC_OFFSET_128(n8, n16, n32, n64, n128, n256, n512, n1024),                                       \
+      POOL_SPEC_OFFSET_256(n8, n16, n32, n64, n128, n256, n512, n1024),                                       \
+      POOL_SPEC_OFFSET_512(n8, n16, n32, n64, n128, n256, n512, n1024),                                       \
+      POOL_SPEC_OFFSET_1024(n8, n16, n32, n64, n128, n256, n512, n1024) },                                    \
+    POOL_SPEC_SIZE(n8, n16, n32, n64, n128, n256, n512, n1024)                                                \
+};                                                                                                            \
+__attribute__ ((aligned(sizeof(uint64_t))))                                                                   \
+static char     _pool_mem_##name[POOL_SPEC_SIZE(n8, n16, n32, n64, n128, n256, n512, n1024)];                 \
+static uint32_t _pool_leaf_##name[POOL_SPEC_WORDS(n8, n16, n32, n64, n128, n256, n512, n1024)];               \
+POOL_BUDDY_##mode(name, n8, n16, n32, n64, n128, n256, n512, n1024)                                           \
+POOL_HISTORY(name)                                                                                            \
+static struct pool_t _pool_obj_##name = { &_pool_geometry_##name, _pool_mem_##name, _pool_leaf_##name,        \
+                                           POOL_BUDDY_PTR_##mode(name), { 0 },                                \
+                                           POOL_SPEC_EMPTY(n8, n16, n32, n64, n128, n256, n512, n1024),       \
+                                           { { 0 } }, POOL_HISTORY_PTR(name), 0, { 0 },                       \
+                                           { POOL_TIMING_INIT, POOL_TIMING_INIT } };                          \
+pool_obj_t const name = &_pool_obj_##name
+
+/*
+ * Dump the statistics and history of a pool as text for the pool sizing tool
+ * (memory/tools/pool_tune.c), one line per call of a printf style function
+ * such as a monitor printAlloc. Lines are terminated with '\r'.
+ *
+ *     POOL <storage bytes> <history count> <history depth>
+ *     CLASS <class bytes> <blocks> <cur_alloc> <max_alloc> <cnt_alloc> <cnt_fail> <waste> <requested>
+ *     TIME <op> <min> <max> <avg> <cnt>                                                     op is MALLOC or FREE
+ *     HIST <entry> ...                                                                      16 per line, hex, oldest first
+ *     END
+ *
+ * CLASS lines are one per partition. TIME lines are output only if POOL_TIMING
+ * is defined, HIST lines only if PROFILE is defined.
+ */
+typedef int (*pool_print_t)(const char * fmt, ...);
+
+void *            poolMallocFrom(pool_obj_t pool, size_t size);   // returns NULL if no block available
+void              poolFreeTo(pool_obj_t pool, void * addr);       // addr not in pool is ignored
+void *            poolReallocFrom(pool_obj_t pool, void * addr, size_t size);   // returns NULL and keeps addr if no block available
+pool_profile_t *  poolProfileOf(pool_obj_t pool);
+void              poolDumpOf(pool_obj_t pool, pool_print_t print);
+
+/*
+ * The default pool
+ */
 void *            poolMalloc(size_t size);
 void              poolFree(void * addr);
+void *            poolRealloc(void * addr, size_t size);
 pool_profile_t *  poolProfile(void);
+void              poolDump(pool_print_t print);
 
 
 #endif  /* _memory_H_ */
@@ -0,0 +1,84 @@
+/*******************************************************************************
+
+    bench_pool.c - Host benchmark of POOL malloc/free time versus pool size.
+
+    Pools of 64 to 4096 blocks are split evenly between the 8, 16, 32 and
+    64 byte partitions. Build and run on the host from this directory, host/
+    has the contract.h, derivative.h and interrupt control of a host build:
+
+    gcc -O2 -DUNIT_TEST -Ihost -I.. -I../../cpu -I../../bitvector -I../../setup bench_pool.c ../memory.c ../../bitvector/bitvector.c ../../cpu/cpu.c -o bench_pool && ./bench_pool
+
+    Each case leaves a single free block at the far end of the pool so that a
+    search proportional to the number of blocks would be exposed:
+
+      last    the last block of the 8 byte partition is the only free block
+      spill   8, 16 and 32 are full, an 8 byte request spills to the last 64 byte block
+
+    COPYRIGHT NOTICE: (c) 2016 DDPA LLC
+    All Rights Reserved
+
+ ******************************************************************************/
+
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <time.h>
+#include  "memory.h"
+
+
+#define BENCH_ITERATIONS    1000000
+#define BENCH_BLOCKS_MAX    4096
+
+void Fault_Handler(void) { }
+ASSERT_INIT;
+
+NEW_POOL(pool_64,     16,   16,   16,   16, 0, 0, 0, 0);
+NEW_POOL(pool_256,    64,   64,   64,   64, 0, 0, 0, 0);
+NEW_POOL(pool_1024,  256,  256,  256,  256, 0, 0, 0, 0);
+NEW_POOL(pool_4096, 1024, 1024, 1024, 1024, 0, 0, 0, 0);
+
+static void *   blk[BENCH_BLOCKS_MAX];
+
+
+static double nsElapsed(struct timespec * start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return ((end.tv_sec - start->tv_sec) * 1e9 + (end.tv_nsec - start->tv_nsec));
+}
+
+/* time a malloc/free pair of size bytes, in ns */
+static double benchPair(pool_obj_t pool, size_t size) {
+    struct timespec start;
+    void * p;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<BENCH_ITERATIONS; ++i) {
+        p = poolMallocFrom(pool, size);
+        poolFreeTo(pool, p);
+    }
+    return (nsElapsed(&start) / BENCH_ITERATIONS);
+}
+
+static void benchPool(pool_obj_t pool) {
+    double  last, spill;
+    int     n = 0;
+
+    while ((blk[n] = poolMallocFrom(pool, 8))) { ++n; }       // fill the entire pool
+
+    poolFreeTo(pool, blk[pool->geometry->blocks[0] - 1]);     // last 8 byte block
+    last = benchPair(pool, 8);
+    (void) poolMallocFrom(pool, 8);
+
+    poolFreeTo(pool, blk[n - 1]);                             // last 64 byte block
+    spill = benchPair(pool, 8);
+
+    printf("%5d blocks   last %6.1f ns   spill %6.1f ns   (malloc + free)\n", n, last, spill);
+}
+
+
+int main(void) {
+    benchPool(pool_64);
+    benchPool(pool_256);
+    benchPool(pool_1024);
+    benchPool(pool_4096);
+    return (0);
+}
@@ -0,0 +1,10 @@
+/*******************************************************************************
+
+    contract.h - Host build of setup/include/utils.h for the memory tests.
+
+    COPYRIGHT NOTICE: (c) 2016 DDPA LLC
+    All Rights Reserved
+
+ ******************************************************************************/
+
+#include  "../../../setup/include/utils.h"
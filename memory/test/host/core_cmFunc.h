@@ -0,0 +1,20 @@
+/*******************************************************************************
+
+    core_cmFunc.h - Host build, the interrupt control used by LOCK / END_LOCK
+    does nothing.
+
+    COPYRIGHT NOTICE: (c) 2016 DDPA LLC
+    All Rights Reserved
+
+ ******************************************************************************/
+
+#ifndef _core_cmFunc_H_
+#define _core_cmFunc_H_
+
+#include  <stdint.h>
+
+static inline uint32_t __get_PRIMASK(void)        { return (0); }
+static inline void     __set_PRIMASK(uint32_t m)  { (void) m; }
+static inline void     __disable_irq(void)        { }
+
+#endif  /* _core_cmFunc_H_ */
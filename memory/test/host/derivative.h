@@ -0,0 +1,8 @@
+/*******************************************************************************
+
+    derivative.h - Host build, no processor, so __CORTEX_M is not defined.
+
+    COPYRIGHT NOTICE: (c) 2016 DDPA LLC
+    All Rights Reserved
+
+ ******************************************************************************/
@@ -0,0 +1,187 @@
+/*******************************************************************************
+
+    pool_tune.c - Host tool that sizes POOL partitions from a pool dump.
+
+    Capture the output of poolDump() / poolDumpOf() (e.g. with the monitor)
+    to a file and run:
+
+    gcc -O2 pool_tune.c -o pool_tune
+    ./pool_tune <RAM budget in bytes> [dump file]
+
+    The dump is read from stdin if no file is given. The peak number of
+    blocks in use at one time in each partition is the larger of max_alloc
+    from the CLASS lines and the peak seen by replaying the HIST lines. A
+    history that has wrapped is replayed from an unknown starting level, so
+    its peak is the rise above the lowest level seen. Either kind of line may
+    be missing; without CLASS lines the default power-of-two classes are used.
+
+    Every partition first gets its peak. Any budget left over is handed out
+    one block at a time to the partition with the smallest margin over its
+    peak. If the peaks do not fit, blocks are removed from the partition
+    with the largest share of its peak. A partition with failed allocations
+    but no peak is treated as having a peak of one block, because its
+    requests were served (or refused) by a larger partition. The peak of a
+    partition with failed allocations is only a lower bound of its demand,
+    so profile again with the new configuration until no failures remain.
+
+    The output is a set of POOL_PARTITION_xx_BLOCKS definitions for memory.h
+    or the command line. The cost of a partition is its block storage plus
+    one 32 bit allocation word per 32 blocks.
+
+    COPYRIGHT NOTICE: (c) 2016 DDPA LLC
+    All Rights Reserved
+
+ ******************************************************************************/
+
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+
+
+#define PARTITIONS          8
+#define BLOCKS_MAX          1024        // POOL_PARTITION_BLOCKS_MAX
+#define HISTORY_ALLOC       0x8000
+#define HISTORY_SIZE        0x7fff
+
+static const char * partition_name[PARTITIONS] = { "8", "16", "32", "64", "128", "256", "512", "1024" };
+
+static long     pool_class[PARTITIONS]    = { 8, 16, 32, 64, 128, 256, 512, 1024 };
+static long     max_alloc[PARTITIONS];
+static long     cnt_fail[PARTITIONS];
+static long     level[PARTITIONS], level_min[PARTITIONS], level_max[PARTITIONS];
+static long     peak[PARTITIONS];
+static long     blocks[PARTITIONS];
+
+
+/* storage and allocation words of n blocks of partition p */
+static long cost(int p, long n) {
+    return ((n * pool_class[p]) + (4 * ((n + 31) / 32)));
+}
+
+static long totalCost(void) {
+    long total = 0;
+    for (int p=0; p<PARTITIONS; ++p) { total += cost(p, blocks[p]); }
+    return (total);
+}
+
+static int partitionOfSize(long size) {
+    for (int p=0; p<PARTITIONS; ++p) {
+        if (pool_class[p] == size) { return (p); }
+    }
+    return (-1);
+}
+
+static void replay(unsigned entry) {
+    int p = partitionOfSize(entry & HISTORY_SIZE);
+
+    if (p < 0) { return; }                        // not a block size of this pool
+    level[p] += (entry & HISTORY_ALLOC) ? 1 : -1;
+    if (level[p] < level_min[p]) { level_min[p] = level[p]; }
+    if (level[p] > level_max[p]) { level_max[p] = level[p]; }
+}
+
+/* parse one line of a dump, lines may end in \r (as output by poolDump), \n, or both */
+static void parseLine(char * line) {
+    static int  p = 0;
+    char *      tok = strtok(line, " \t");
+
+    if (!tok) { return; }
+    if (!strcmp(tok, "CLASS") && (p < PARTITIONS)) {
+        long v[7] = { 0 };
+        for (int i=0; (i<7) && (tok = strtok(NULL, " \t")); ++i) { v[i] = strtol(tok, NULL, 0); }
+        pool_class[p] = v[0];
+        max_alloc[p]  = v[3];
+        cnt_fail[p]   = v[5];
+        ++p;
+    }
+    else if (!strcmp(tok, "HIST")) {
+        while ((tok = strtok(NULL, " \t"))) { replay((unsigned) strtoul(tok, NULL, 16)); }
+    }
+}
+
+static void parse(FILE * f) {
+    char    line[256];
+    int     c, n = 0;
+
+    while ((c = fgetc(f)) != EOF) {
+        if ((c == '\r') || (c == '\n')) {
+            line[n] = '\0';
+            parseLine(line);
+            n = 0;
+        }
+        else if (n < (int) sizeof(line) - 1) {
+            line[n++] = (char) c;
+        }
+    }
+    line[n] = '\0';
+    parseLine(line);
+}
+
+/* partition with the smallest (add) or largest (!add) margin of blocks over its peak that can change by one block */
+static int pickPartition(int add, long budget) {
+    int     best = -1;
+    double  ratio, best_ratio = 0;
+
+    for (int p=0; p<PARTITIONS; ++p) {
+        if (!peak[p]) { continue; }
+        if (add && ((blocks[p] >= BLOCKS_MAX) || (totalCost() - cost(p, blocks[p]) + cost(p, blocks[p] + 1) > budget))) { continue; }
+        if (!add && !blocks[p]) { continue; }
+        ratio = (double) blocks[p] / peak[p];
+        if ((best < 0) || (add ? (ratio < best_ratio) : (ratio > best_ratio))) {
+            best = p;
+            best_ratio = ratio;
+        }
+    }
+    return (best);
+}
+
+
+int main(int argc, char * argv[]) {
+    FILE *  f = stdin;
+    long    budget, need;
+    int     p;
+
+    if ((argc < 2) || ((budget = strtol(argv[1], NULL, 0)) <= 0)) {
+        fprintf(stderr, "usage: %s <RAM budget in bytes> [dump file]\n", argv[0]);
+        return (1);
+    }
+    if ((argc > 2) && !(f = fopen(argv[2], "r"))) {
+        perror(argv[2]);
+        return (1);
+    }
+    parse(f);
+
+    for (p=0; p<PARTITIONS; ++p) {
+        peak[p] = level_max[p] - level_min[p];
+        if (max_alloc[p] > peak[p]) { peak[p] = max_alloc[p]; }
+        if (!peak[p] && cnt_fail[p]) { peak[p] = 1; }
+        if (peak[p] > BLOCKS_MAX)    { peak[p] = BLOCKS_MAX; }
+        blocks[p] = peak[p];
+    }
+
+    need = totalCost();
+    if (need > budget) {
+        while ((totalCost() > budget) && ((p = pickPartition(0, budget)) >= 0)) { --blocks[p]; }
+    }
+    else {
+        while ((p = pickPartition(1, budget)) >= 0) { ++blocks[p]; }
+    }
+
+    printf("/* pool_tune: budget %ld bytes, peak demand %ld bytes, configuration %ld bytes */\n", budget, need, totalCost());
+    printf("/*   class   peak  fails  blocks */\n");
+    for (p=0; p<PARTITIONS; ++p) {
+        printf("/* %7ld %6ld %6ld %7ld */\n", pool_class[p], peak[p], cnt_fail[p], blocks[p]);
+    }
+    for (p=0; p<PARTITIONS; ++p) {
+        if (cnt_fail[p]) {
+            printf("/* WARNING: %ld byte partition was exhausted, its demand may be higher than its peak */\n", pool_class[p]);
+        }
+    }
+    if (need > budget) {
+        printf("/* WARNING: peak demand exceeds the budget by %ld bytes, allocations will spill or fail */\n", need - budget);
+    }
+    for (p=0; p<PARTITIONS; ++p) {
+        printf("#define POOL_PARTITION_%s_BLOCKS%*s%ld\n", partition_name[p], (int) (8 - strlen(partition_name[p])), "", blocks[p]);
+    }
+    return (0);
+}
@@ -24,6 +24,7 @@ static int      _printAlloc(const char *fmt, ...);
 static uint8_t  _cmdFilter(char * ip_cmd);
 
 static int      _calibrateCmd(void);
+static int      _dumpPoolCmd(void);
 static int      _helpCmd(void);
 static int      _intervalCmd(void);
 static int      _labelCmd(void);
@@ -48,6 +49,7 @@ static uint8_t                  mon_cmd_ip_str_len = 0;
 static const char               mon_cmd_prompt_str[] = "CMD> ";
 static cmd_t                    mon_cmd_parsed_cmd;
 static mon_cmd_action_t         mon_cmd_action[] = { { "c", _calibrateCmd },
+                                                     { "d", _dumpPoolCmd },
                                                      { "h", _helpCmd },
                                                      { "i", _intervalCmd},
                                                      { "l", _labelCmd},
@@ -77,6 +79,7 @@ mon_obj_t  mon_cmd_obj = {
 static const char mon_cmd_help_message[] = "\rCOMMAND (CMD>) MONITOR COMMANDS:\r\
 [H]elp                                This help message\r\
 [C]alibrate                           Perform a system-level calibration\r\
+[D]ump Pool                           Dump memory pool statistics, timing, history\r\
 [I]nterval < 1 | 10 | 100 | 1000 > ms Configure reporting interval\r\
 [L]abel < [A..z] Report Header Text > Print custom label over report header\r\
 [M]onitor Change                      Change from command to debug monitor\r\
@@ -163,6 +166,7 @@ static uint8_t _cmdFilter (char * ip_cmd) {
  *
  * [H]elp                                This help message
  * [C]alibrate                           Perform a system-level calibration
+ * [D]ump Pool                           Dump memory pool statistics, timing, history
  * [I]nterval < 1 | 10 | 100 | 1000 > ms Configure reporting interval
  * [L]abel < [A..z] Report Header Text > Print custom label over report header
  * [M]onitor Change                      Change from command to debug monitor
@@ -185,6 +189,12 @@ static int _calibrateCmd(void) {
 }
 
 
+static int _dumpPoolCmd(void) {
+    poolDump(_printAlloc);      // for memory/tools/pool_tune
+    return (MON_CMD_RTN_NO_ACTION);
+}
+
+
 static int _intervalCmd(void) {
     mon_cmd_app_data_t  * p_app_data = (mon_cmd_app_data_t *) mon_cmd_obj.p_app_data;
     uint16_t intv = (uint16_t) mon_cmd_obj.p_parsed_cmd->token[1].num;
@@ -41,11 +41,25 @@ void  openSDAInit(void) {
 
 
 /// Get / Put / Write
+/// Characters that do not prime the UART are copied straight into the tx fifo storage.
 void  openSDAWrite(char *s) {
+    fifo_index_t  n;
+    char *        span;
 
     while (*s) {
-        while (!openSDAPut(*s));
-        ++s;
+        LOCK;
+        if (_openSDAUARTPrime(*s)) {
+            n = 1;
+        }
+        else {
+            span = fifoWriteSpan(tx_buf, &n);
+            for (fifo_index_t i=0; i<n; ++i) {
+                if (!(span[i] = s[i])) { n = i; break; }
+            }
+            fifoCommitWrite(tx_buf, n);
+        }
+        END_LOCK;
+        s += n;
     }
 }
 
@@ -54,14 +68,14 @@ bool  openSDAPut(char c) {
 
     LOCK;
     if (!_openSDAUARTPrime(c)) {
-        rslt = fifoPush((TFifo) &tx_buf, c);
+        rslt = fifoPush(tx_buf, c);
     }
     END_LOCK;
     return (rslt);
 }
 
 bool  openSDAGet(char *c) {
-    return (fifoPop((TFifo) &rx_buf, c));
+    return (fifoPop(rx_buf, c));
 }
 
 
@@ -154,7 +168,7 @@ void LPUART0_IRQHandler(void) {
     char c;
 
     if (LPUART0_STAT & LPUART_STAT_TDRE_MASK) {
-        if (fifoPop((TFifo) &tx_buf, &c) ){
+        if (fifoPop(tx_buf, &c) ){
             LPUART0_DATA = (uint32_t) c;
         }
         else {
@@ -164,7 +178,7 @@ void LPUART0_IRQHandler(void) {
 
     if (LPUART0_STAT & LPUART_STAT_RDRF_MASK) {
         c = (char) (LPUART0_DATA & 0x000000ff);
-        fifoPush((TFifo) &rx_buf, c);
+        fifoPush(rx_buf, c);
     }
 }
 #endif  /* MCU_MKL43Z4 */
@@ -204,7 +218,7 @@ void UART1_RX_TX_IRQHandler(void) {
     char c;
 
     if (UART1_S1 & UART_S1_TDRE_MASK) {
-        if (fifoPop((TFifo) &tx_buf, &c) ){
+        if (fifoPop(tx_buf, &c) ){
             UART1_D = c;
         }
         else {
@@ -214,7 +228,7 @@ void UART1_RX_TX_IRQHandler(void) {
 
     if (UART1_S1 & UART_S1_RDRF_MASK) {
         c = UART1_D;
-        fifoPush((TFifo) &rx_buf, c);
+        fifoPush(rx_buf, c);
     }
 }
 #endif  /* MCU_MK22F25612 */